@@ -1,5 +1,24 @@
 #include "Big_int.h"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <system_error>
+#include <vector>
+
+std::size_t Big_int::karatsuba_threshold = 32;
+std::size_t Big_int::toom3_threshold = 120;
+std::size_t Big_int::ntt_threshold = 1'000;
+std::size_t Big_int::newton_division_threshold = 3'000;
+std::size_t Big_int::thread_count = 1;
+std::size_t Big_int::parallel_threshold = 2'000;
+Simd_level Big_int::simd_level = supported_simd_level();
+std::atomic<std::size_t> Big_int::_active_threads = 0;
+
 //++++++++++++++++++++Support functions+++++++++++++++++++++++++++
 //--------------------Static functions----------------------------
 void Big_int::_delete_leading_zeros(container_type& _data)
@@ -36,169 +55,1065 @@ int Big_int::_veccmp(const container_type& _lhs_data, const container_type& _rhs
 	else if (_lhs_data.size() < _rhs_data.size()) {
 		return -1;
 	}
-	for (size_type i = _lhs_data.size(); i != 0; --i) {
+	return _kernels::compare(_lhs_data.data(), _rhs_data.data(), _lhs_data.size(), simd_level);
+}
+
+Big_int::container_type
+Big_int::_slice(const container_type& _data, size_type _first, size_type _last)
+{
+	_first = std::min(_first, _data.size());
+	_last = std::min(_last, _data.size());
+	container_type ret(_data.begin() + _first, _data.begin() + _last);
+	_delete_leading_zeros(ret);
+	return ret;
+}
+
+void Big_int::_add_shifted(container_type& _data, const container_type& _rhs_data, size_type _shift)
+{
+	if (_rhs_data.empty()) {
+		return;
+	}
+	if (_data.size() < _shift + _rhs_data.size()) {
+		_data.resize(_shift + _rhs_data.size(), 0);
+	}
+	base_type* data = _data.data() + _shift;
+	base_type carry = _kernels::add(data, data, _rhs_data.data(), _rhs_data.size(), 0, simd_level);
+	for (size_type i = _shift + _rhs_data.size(); carry != 0; ++i) {
+		if (i == _data.size()) {
+			_data.push_back(carry);
+			break;
+		}
+		base_type sum = _data[i] + carry;
+		carry = sum >= _BASE;
+		_data[i] = carry ? sum - _BASE : sum;
+	}
+}
+
+void Big_int::_subtract(container_type& _data, const container_type& _rhs_data)
+{
+	base_type borrowed = _kernels::subtract(_data.data(), _data.data(), _rhs_data.data(), _rhs_data.size(), 0, simd_level);
+	for (size_type i = _rhs_data.size(); i < _data.size() and borrowed != 0; ++i) {
+		borrowed = _data[i] == 0;
+		_data[i] = borrowed ? _BASE - 1 : _data[i] - 1;
+	}
+	_delete_leading_zeros(_data);
+}
+
+Big_int::base_type Big_int::_addmul_1(base_type* _result, const base_type* _data, size_type _size, base_type _number)
+{
+	double_base_type carry = 0;
+	for (size_type i = 0; i < _size; ++i) {
+		double_base_type cur = static_cast<double_base_type>(_data[i]) * _number + _result[i] + carry;
+		carry = cur / _BASE;
+		_result[i] = static_cast<base_type>(cur % _BASE);
+	}
+	return static_cast<base_type>(carry);
+}
+
+void Big_int::_multiply_by_word(container_type& _data, base_type _number)
+{
+	double_base_type carry = 0;
+	for (auto& limb : _data) {
+		double_base_type product = static_cast<double_base_type>(limb) * _number + carry;
+		limb = static_cast<base_type>(product % _BASE);
+		carry = product / _BASE;
+	}
+	// _number can exceed _BASE, then the carry takes two limbs.
+	while (carry > 0) {
+		_data.push_back(static_cast<base_type>(carry % _BASE));
+		carry /= _BASE;
+	}
+	_delete_leading_zeros(_data);
+}
+
+void Big_int::_add_word(container_type& _data, double_base_type _number)
+{
+	for (size_type i = 0; _number != 0; ++i) {
+		if (i == _data.size()) {
+			_data.push_back(0);
+		}
+		double_base_type cur = _data[i] + _number;
+		_data[i] = static_cast<base_type>(cur % _BASE);
+		_number = cur / _BASE;
+	}
+}
+
+void Big_int::_subtract_word(container_type& _data, double_base_type _number)
+{
+	for (size_type i = 0; _number != 0; ++i) {
+		base_type limb = static_cast<base_type>(_number % _BASE);
+		_number /= _BASE;
+		if (_data[i] < limb) {
+			_data[i] += _BASE - limb;
+			++_number;
+		}
+		else {
+			_data[i] -= limb;
+		}
+	}
+	_delete_leading_zeros(_data);
+}
+
+void Big_int::_shift_left_limbs(container_type& _data, size_type _shift)
+{
+	if (!_data.empty()) {
+		_data.insert(_data.begin(), _shift, 0);
+	}
+}
+
+void Big_int::_shift_right_limbs(container_type& _data, size_type _shift)
+{
+	_data.erase(_data.begin(), _data.begin() + std::min(_shift, _data.size()));
+}
+
+Big_int::base_type Big_int::_divide_by_word(container_type& _data, base_type _divisor)
+{
+	double_base_type remainder = 0;
+	for (size_type i = _data.size(); i != 0; --i) {
 		size_type reverse_i = i - 1;
-		if (_lhs_data[reverse_i] > _rhs_data[reverse_i]) {
-			return 1;
+		double_base_type cur = remainder * _BASE + _data[reverse_i];
+		_data[reverse_i] = static_cast<base_type>(cur / _divisor);
+		remainder = cur % _divisor;
+	}
+	_delete_leading_zeros(_data);
+	return static_cast<base_type>(remainder);
+}
+
+bool Big_int::_is_parallel(size_type _size)
+{
+	return thread_count > 1 and _size >= parallel_threshold and current_limb_resource() == nullptr;
+}
+
+Big_int::size_type Big_int::_acquire_threads(size_type _count)
+{
+	size_type active = _active_threads.load();
+	size_type count = 0;
+	do {
+		// The calling thread is one of thread_count.
+		size_type available = thread_count > active + 1 ? thread_count - active - 1 : 0;
+		count = std::min(_count, available);
+		if (count == 0) {
+			break;
+		}
+	} while (!_active_threads.compare_exchange_weak(active, active + count));
+	return count;
+}
+
+void Big_int::_parallel_for(size_type _count, size_type _size, const std::function<void(size_type)>& _task)
+{
+	size_type threads = _count > 1 and _is_parallel(_size) ? _acquire_threads(_count - 1) : 0;
+	if (threads == 0) {
+		for (size_type i = 0; i < _count; ++i) {
+			_task(i);
 		}
-		else if (_lhs_data[reverse_i] < _rhs_data[reverse_i]) {
-			return -1;
+		return;
+	}
+
+	std::atomic<size_type> next = 0;
+	auto work = [&]() {
+		for (size_type i = next++; i < _count; i = next++) {
+			_task(i);
 		}
+	};
+	std::vector<std::future<void>> workers;
+	workers.reserve(threads);
+	for (size_type i = 0; i < threads; ++i) {
+		try {
+			workers.push_back(std::async(std::launch::async, work));
+		}
+		catch (const std::system_error&) {
+			break; // The remaining tasks run on the started threads.
+		}
+	}
+	std::exception_ptr error;
+	try {
+		work();
+	}
+	catch (...) {
+		error = std::current_exception();
+	}
+	for (auto& worker : workers) {
+		try {
+			worker.get();
+		}
+		catch (...) {
+			if (!error) {
+				error = std::current_exception();
+			}
+		}
+	}
+	_active_threads -= threads;
+	if (error) {
+		std::rethrow_exception(error);
 	}
-	return 0;
 }
 
 Big_int::container_type
 Big_int::_multiply_data(const container_type& _lhs_data,
 						const container_type& _rhs_data)
+{
+	if (&_lhs_data == &_rhs_data) {
+		return _square_data(_lhs_data);
+	}
+	const container_type& short_data = _lhs_data.size() < _rhs_data.size() ? _lhs_data : _rhs_data;
+	const container_type& long_data = _lhs_data.size() < _rhs_data.size() ? _rhs_data : _lhs_data;
+	if (short_data.size() < std::max<std::size_t>(karatsuba_threshold, 2)) {
+		return _schoolbook_multiply(long_data, short_data);
+	}
+	else if (short_data.size() >= ntt_threshold and
+		long_data.size() + short_data.size() <= _NTT_MAX_SIZE) {
+		return _ntt_multiply(long_data, short_data);
+	}
+	else if (long_data.size() >= 2 * short_data.size()) {
+		return _unbalanced_multiply(long_data, short_data);
+	}
+	else if (short_data.size() < std::max<std::size_t>(toom3_threshold, 3)) {
+		return _karatsuba_multiply(long_data, short_data);
+	}
+	else {
+		return _toom3_multiply(long_data, short_data);
+	}
+}
+
+Big_int::container_type
+Big_int::_schoolbook_multiply(	const container_type& _lhs_data,
+								const container_type& _rhs_data)
 {
 	container_type result(_lhs_data.size() + _rhs_data.size(), 0);
 	for (size_type i = 0; i < _lhs_data.size(); ++i) {
-		double_base_type carry = 0;
-		for (size_type j = 0; j < _rhs_data.size(); ++j) {
-			double_base_type mul =
-				static_cast<double_base_type>(_lhs_data[i]) * _rhs_data[j] + carry;
-			carry = (result[i + j] + mul) / _BASE;
-			result[i + j] = static_cast<base_type>((result[i + j] + mul) % _BASE);
-		}
-		if (carry > 0) {
-			result[i + _rhs_data.size()] = carry;
-		}
+		result[i + _rhs_data.size()] = _addmul_1(result.data() + i, _rhs_data.data(), _rhs_data.size(), _lhs_data[i]);
+	}
+	_delete_leading_zeros(result);
+	return result;
+}
+
+Big_int::container_type
+Big_int::_karatsuba_multiply(	const container_type& _lhs_data,
+								const container_type& _rhs_data)
+{
+	// (a1 * B^k + a0) * (b1 * B^k + b0) =
+	// z2 * B^2k + ((a0 + a1) * (b0 + b1) - z2 - z0) * B^k + z0
+	size_type k = (std::max(_lhs_data.size(), _rhs_data.size()) + 1) / 2;
+	container_type a0 = _slice(_lhs_data, 0, k);
+	container_type a1 = _slice(_lhs_data, k, _lhs_data.size());
+	container_type b0 = _slice(_rhs_data, 0, k);
+	container_type b1 = _slice(_rhs_data, k, _rhs_data.size());
+
+	container_type z0, z1, z2;
+	size_type size = std::min(_lhs_data.size(), _rhs_data.size());
+	if (_is_parallel(size)) {
+		// The sums cannot overwrite a0 and b0 while z0 is computed.
+		container_type a_sum = a0;
+		container_type b_sum = b0;
+		_add_shifted(a_sum, a1, 0);
+		_add_shifted(b_sum, b1, 0);
+		_parallel_for(3, size, [&](size_type i) {
+			switch (i) {
+			case 0: z0 = _multiply_data(a0, b0); break;
+			case 1: z2 = _multiply_data(a1, b1); break;
+			default: z1 = _multiply_data(a_sum, b_sum);
+			}
+		});
+	}
+	else {
+		z0 = _multiply_data(a0, b0);
+		z2 = _multiply_data(a1, b1);
+		_add_shifted(a0, a1, 0);
+		_add_shifted(b0, b1, 0);
+		z1 = _multiply_data(a0, b0);
 	}
+	_subtract(z1, z0);
+	_subtract(z1, z2);
+
+	container_type result = std::move(z0);
+	result.reserve(_lhs_data.size() + _rhs_data.size());
+	_add_shifted(result, z1, k);
+	_add_shifted(result, z2, 2 * k);
 	_delete_leading_zeros(result);
 	return result;
 }
 
 Big_int::container_type
-Big_int::_divide_data(	const container_type& _lhs_data,
+Big_int::_toom3_multiply(	const container_type& _lhs_data,
+							const container_type& _rhs_data)
+{
+	// Evaluation at 0, 1, -1, -2, infinity and interpolation by Bodrato's sequence.
+	// The intermediate values can be negative, so they are kept as Big_int.
+	size_type k = (std::max(_lhs_data.size(), _rhs_data.size()) + 2) / 3;
+	auto evaluate = [k](const container_type& data, Big_int (&values)[5]) {
+		Big_int x0, x1, x2;
+		x0._data = _slice(data, 0, k);
+		x1._data = _slice(data, k, 2 * k);
+		x2._data = _slice(data, 2 * k, data.size());
+		Big_int sum = x0 + x2;
+		values[1] = sum + x1;
+		values[2] = std::move(sum) - x1;
+		values[3] = (values[2] + x2) * 2 - x0;
+		values[0] = std::move(x0);
+		values[4] = std::move(x2);
+	};
+
+	// Values at 0, 1, -1, -2, infinity
+	Big_int a[5];
+	evaluate(_lhs_data, a);
+	Big_int r[5];
+	size_type size = std::min(_lhs_data.size(), _rhs_data.size());
+	if (&_lhs_data == &_rhs_data) {
+		_parallel_for(5, size, [&](size_type i) {
+			r[i] = square(std::move(a[i]));
+		});
+	}
+	else {
+		Big_int b[5];
+		evaluate(_rhs_data, b);
+		_parallel_for(5, size, [&](size_type i) {
+			r[i] = a[i] * b[i];
+		});
+	}
+	auto& [r0, r1, r2, r3, r4] = r;
+
+	// The divisions are exact.
+	r3 -= r1;
+	r3.divmod_word(3);
+	r1 -= r2;
+	r1.divmod_word(2);
+	r2 -= r0;
+	r3 = r2 - r3;
+	r3.divmod_word(2);
+	r3 += r4 * 2;
+	r2 += r1;
+	r2 -= r4;
+	r1 -= r3;
+
+	container_type result = std::move(r0._data);
+	result.reserve(_lhs_data.size() + _rhs_data.size());
+	_add_shifted(result, r1._data, k);
+	_add_shifted(result, r2._data, 2 * k);
+	_add_shifted(result, r3._data, 3 * k);
+	_add_shifted(result, r4._data, 4 * k);
+	_delete_leading_zeros(result);
+	return result;
+}
+
+Big_int::container_type Big_int::_square_data(const container_type& _data)
+{
+	if (_data.size() < std::max<std::size_t>(karatsuba_threshold, 2)) {
+		return _schoolbook_square(_data);
+	}
+	else if (_data.size() >= ntt_threshold and 2 * _data.size() <= _NTT_MAX_SIZE) {
+		return _ntt_multiply(_data, _data);
+	}
+	else if (_data.size() < std::max<std::size_t>(toom3_threshold, 3)) {
+		return _karatsuba_square(_data);
+	}
+	else {
+		return _toom3_multiply(_data, _data);
+	}
+}
+
+Big_int::container_type Big_int::_schoolbook_square(const container_type& _data)
+{
+	size_type n = _data.size();
+	container_type result(2 * n, 0);
+
+	// Sum of _data[i] * _data[j] for i < j
+	for (size_type i = 0; i < n; ++i) {
+		result[i + n] = _addmul_1(result.data() + 2 * i + 1, _data.data() + i + 1, n - i - 1, _data[i]);
+	}
+
+	// Double the cross products and add the squares _data[i] * _data[i]
+	double_base_type carry = 0;
+	for (size_type i = 0; i < n; ++i) {
+		double_base_type square = static_cast<double_base_type>(_data[i]) * _data[i];
+		double_base_type cur = 2 * static_cast<double_base_type>(result[2 * i]) + square % _BASE + carry;
+		result[2 * i] = static_cast<base_type>(cur % _BASE);
+		carry = cur / _BASE;
+		cur = 2 * static_cast<double_base_type>(result[2 * i + 1]) + square / _BASE + carry;
+		result[2 * i + 1] = static_cast<base_type>(cur % _BASE);
+		carry = cur / _BASE;
+	}
+	_delete_leading_zeros(result);
+	return result;
+}
+
+Big_int::container_type Big_int::_karatsuba_square(const container_type& _data)
+{
+	// (a1 * B^k + a0)^2 = z2 * B^2k + ((a0 + a1)^2 - z2 - z0) * B^k + z0
+	size_type k = (_data.size() + 1) / 2;
+	container_type a0 = _slice(_data, 0, k);
+	container_type a1 = _slice(_data, k, _data.size());
+
+	container_type z0, z1, z2;
+	if (_is_parallel(_data.size())) {
+		container_type a_sum = a0;
+		_add_shifted(a_sum, a1, 0);
+		_parallel_for(3, _data.size(), [&](size_type i) {
+			switch (i) {
+			case 0: z0 = _square_data(a0); break;
+			case 1: z2 = _square_data(a1); break;
+			default: z1 = _square_data(a_sum);
+			}
+		});
+	}
+	else {
+		z0 = _square_data(a0);
+		z2 = _square_data(a1);
+		_add_shifted(a0, a1, 0);
+		z1 = _square_data(a0);
+	}
+	_subtract(z1, z0);
+	_subtract(z1, z2);
+
+	container_type result = std::move(z0);
+	result.reserve(2 * _data.size());
+	_add_shifted(result, z1, k);
+	_add_shifted(result, z2, 2 * k);
+	_delete_leading_zeros(result);
+	return result;
+}
+
+Big_int::base_type Big_int::_pow_mod(base_type _number, double_base_type _power, base_type _mod)
+{
+	double_base_type ret = 1;
+	double_base_type base = _number % _mod;
+	while (_power != 0) {
+		if (_power & 1) {
+			ret = ret * base % _mod;
+		}
+		base = base * base % _mod;
+		_power >>= 1;
+	}
+	return static_cast<base_type>(ret);
+}
+
+void Big_int::_ntt(container_type& _data, bool _invert, base_type _mod)
+{
+	size_type n = _data.size();
+	for (size_type i = 1, j = 0; i < n; ++i) {
+		size_type bit = n >> 1;
+		for (; j & bit; bit >>= 1) {
+			j ^= bit;
+		}
+		j ^= bit;
+		if (i < j) {
+			std::swap(_data[i], _data[j]);
+		}
+	}
+
+	container_type roots(n / 2);
+	for (size_type len = 2; len <= n; len <<= 1) {
+		base_type root = _pow_mod(_NTT_ROOT, (_mod - 1) / len, _mod);
+		if (_invert) {
+			root = _pow_mod(root, _mod - 2, _mod);
+		}
+		size_type half = len / 2;
+		roots[0] = 1;
+		for (size_type i = 1; i < half; ++i) {
+			roots[i] = static_cast<base_type>(static_cast<double_base_type>(roots[i - 1]) * root % _mod);
+		}
+		for (size_type i = 0; i < n; i += len) {
+			for (size_type j = 0; j < half; ++j) {
+				base_type u = _data[i + j];
+				base_type v = static_cast<base_type>(static_cast<double_base_type>(_data[i + j + half]) * roots[j] % _mod);
+				_data[i + j] = u + v < _mod ? u + v : u + v - _mod;
+				_data[i + j + half] = u >= v ? u - v : u + _mod - v;
+			}
+		}
+	}
+
+	if (_invert) {
+		double_base_type inverse_n = _pow_mod(static_cast<base_type>(n % _mod), _mod - 2, _mod);
+		for (auto& number : _data) {
+			number = static_cast<base_type>(number * inverse_n % _mod);
+		}
+	}
+}
+
+Big_int::container_type
+Big_int::_ntt_multiply(	const container_type& _lhs_data,
 						const container_type& _rhs_data)
 {
-	container_type ret;
-	Big_int cur_val;
-	for (size_type i = _lhs_data.size(); i != 0; --i) {
-		size_type reverse_i = i - 1;
-		cur_val = cur_val * _BASE + _lhs_data[reverse_i];
-		base_type quotient = 0;
-		base_type l = 0;
-		base_type r = _BASE;
-		while (l <= r) {
-			base_type mid = (l + r) / 2;
-			container_type temp = _multiply_data(_rhs_data, Big_int(mid)._data);
-			int cmp = _veccmp(cur_val._data, temp);
-			if (cmp == 1 or cmp == 0) {
-				quotient = mid;
-				l = mid + 1;
+	size_type result_size = _lhs_data.size() + _rhs_data.size();
+	size_type n = 1;
+	while (n < result_size) {
+		n <<= 1;
+	}
+
+	// Squaring needs one forward transform per prime
+	bool is_square = &_lhs_data == &_rhs_data;
+	container_type residues[3];
+	_parallel_for(3, std::min(_lhs_data.size(), _rhs_data.size()), [&](size_type k) {
+		base_type mod = _NTT_PRIMES[k];
+		container_type lhs(n, 0);
+		for (size_type i = 0; i < _lhs_data.size(); ++i) {
+			lhs[i] = _lhs_data[i] % mod;
+		}
+		_ntt(lhs, false, mod);
+		if (is_square) {
+			for (size_type i = 0; i < n; ++i) {
+				lhs[i] = static_cast<base_type>(static_cast<double_base_type>(lhs[i]) * lhs[i] % mod);
+			}
+		}
+		else {
+			container_type rhs(n, 0);
+			for (size_type i = 0; i < _rhs_data.size(); ++i) {
+				rhs[i] = _rhs_data[i] % mod;
 			}
-			else {
-				r = mid - 1;
+			_ntt(rhs, false, mod);
+			for (size_type i = 0; i < n; ++i) {
+				lhs[i] = static_cast<base_type>(static_cast<double_base_type>(lhs[i]) * rhs[i] % mod);
 			}
 		}
-		ret.push_back(quotient);
-		Big_int incomplete_divisible;
-		incomplete_divisible._data = _multiply_data(_rhs_data, Big_int(quotient)._data);
-		cur_val -= incomplete_divisible;
+		_ntt(lhs, true, mod);
+		residues[k] = std::move(lhs);
+	});
+
+	// Garner's algorithm: x = r0 + p0 * t1 + p0 * p1 * t2
+	const double_base_type p0 = _NTT_PRIMES[0];
+	const double_base_type p1 = _NTT_PRIMES[1];
+	const double_base_type p2 = _NTT_PRIMES[2];
+	const double_base_type p0_inverse_mod_p1 = _pow_mod(_NTT_PRIMES[0] % _NTT_PRIMES[1], p1 - 2, _NTT_PRIMES[1]);
+	const double_base_type p0p1_mod_p2 = p0 % p2 * (p1 % p2) % p2;
+	const double_base_type p0p1_inverse_mod_p2 = _pow_mod(static_cast<base_type>(p0p1_mod_p2), p2 - 2, _NTT_PRIMES[2]);
+	const double_base_type p0p1_low = p0 * p1 % _BASE;
+	const double_base_type p0p1_high = p0 * p1 / _BASE;
+
+	container_type result(result_size, 0);
+	double_base_type carry[3] = { 0, 0, 0 };
+	for (size_type i = 0; i < result_size; ++i) {
+		double_base_type r0 = residues[0][i];
+		double_base_type r1 = residues[1][i];
+		double_base_type r2 = residues[2][i];
+		double_base_type t1 = (r1 + p1 - r0 % p1) * p0_inverse_mod_p1 % p1;
+		double_base_type low = r0 + p0 * t1;
+		double_base_type t2 = (r2 + p2 - low % p2) * p0p1_inverse_mod_p2 % p2;
+
+		// x + carry as base _BASE digits d0, d1, d2
+		double_base_type t2_low = t2 * p0p1_low;
+		double_base_type t2_high = t2 * p0p1_high;
+		double_base_type d0 = low % _BASE + t2_low % _BASE + carry[0];
+		double_base_type d1 = low / _BASE + t2_low / _BASE + t2_high % _BASE + carry[1] + d0 / _BASE;
+		double_base_type d2 = t2_high / _BASE + carry[2] + d1 / _BASE;
+		result[i] = static_cast<base_type>(d0 % _BASE);
+		carry[0] = d1 % _BASE;
+		carry[1] = d2 % _BASE;
+		carry[2] = d2 / _BASE;
 	}
-	_reverse(ret);
-	_delete_leading_zeros(ret);
-	return ret;
+	_delete_leading_zeros(result);
+	return result;
 }
 
 Big_int::container_type
-Big_int::_take_remainder_data(	const container_type& _lhs_data,
-								const container_type& _rhs_data)
+Big_int::_unbalanced_multiply(	const container_type& _long_data,
+								const container_type& _short_data)
 {
-	Big_int ret;
-	for (size_type i = _lhs_data.size(); i != 0; --i) {
-		size_type reverse_i = i - 1;
-		ret = ret * _BASE + _lhs_data[reverse_i];
-		base_type quotient = 0;
-		base_type l = 0;
-		base_type r = _BASE;
-		while (l <= r) {
-			base_type mid = (l + r) / 2;
-			container_type temp = _multiply_data(_rhs_data, Big_int(mid)._data);
-			int cmp = _veccmp(ret._data, temp);
-			if (cmp == 1 or cmp == 0) {
-				quotient = mid;
-				l = mid + 1;
+	// The sum does not depend on the order in which the chunk products are added.
+	container_type result;
+	result.reserve(_long_data.size() + _short_data.size());
+	std::mutex result_mutex;
+	size_type chunk_size = _short_data.size();
+	_parallel_for((_long_data.size() + chunk_size - 1) / chunk_size, chunk_size, [&](size_type i) {
+		container_type chunk = _slice(_long_data, i * chunk_size, (i + 1) * chunk_size);
+		container_type product = _multiply_data(chunk, _short_data);
+		std::lock_guard<std::mutex> lock(result_mutex);
+		_add_shifted(result, product, i * chunk_size);
+	});
+	_delete_leading_zeros(result);
+	return result;
+}
+
+std::pair<Big_int::container_type, Big_int::container_type>
+Big_int::_divmod_data(	const container_type& _lhs_data,
+						const container_type& _rhs_data)
+{
+	if (_rhs_data.size() >= newton_division_threshold and
+		_lhs_data.size() >= _rhs_data.size() + newton_division_threshold) {
+		return _newton_divmod(_lhs_data, _rhs_data);
+	}
+	return _schoolbook_divmod(_lhs_data, _rhs_data);
+}
+
+std::pair<Big_int::container_type, Big_int::container_type>
+Big_int::_schoolbook_divmod(const container_type& _lhs_data,
+							const container_type& _rhs_data)
+{
+	if (_veccmp(_lhs_data, _rhs_data) == -1) {
+		return { container_type(), _lhs_data };
+	}
+	if (_rhs_data.size() == 1) {
+		container_type quotient = _lhs_data;
+		base_type remainder = _divide_by_word(quotient, _rhs_data.front());
+		return { quotient, remainder == 0 ? container_type() : container_type(1, remainder) };
+	}
+
+	// D1. Normalize so that the leading limb of the divisor is at least _BASE / 2.
+	base_type factor = _BASE / (_rhs_data.back() + 1);
+	container_type u = _lhs_data;
+	container_type v = _rhs_data;
+	_multiply_by_word(u, factor);
+	_multiply_by_word(v, factor);
+	size_type n = v.size();
+	size_type m = _lhs_data.size() - n;
+	u.resize(_lhs_data.size() + 1, 0);
+
+	container_type quotient(m + 1, 0);
+	const double_base_type v_top = v[n - 1];
+	const double_base_type v_next = v[n - 2];
+	for (size_type j = m + 1; j != 0; --j) {
+		size_type reverse_j = j - 1;
+
+		// D3. Estimate the quotient limb from the top limbs; it is at most two too large.
+		double_base_type numerator = static_cast<double_base_type>(u[reverse_j + n]) * _BASE + u[reverse_j + n - 1];
+		double_base_type q_hat = numerator / v_top;
+		double_base_type r_hat = numerator % v_top;
+		while (q_hat >= _BASE or q_hat * v_next > r_hat * _BASE + u[reverse_j + n - 2]) {
+			--q_hat;
+			r_hat += v_top;
+			if (r_hat >= _BASE) {
+				break;
 			}
-			else {
-				r = mid - 1;
+		}
+
+		// D4. Multiply and subtract.
+		double_base_type carry = 0;
+		long long borrowed = 0;
+		for (size_type i = 0; i < n; ++i) {
+			double_base_type product = q_hat * v[i] + carry;
+			carry = product / _BASE;
+			long long diff = static_cast<long long>(u[reverse_j + i]) - static_cast<long long>(product % _BASE) - borrowed;
+			borrowed = diff < 0;
+			u[reverse_j + i] = static_cast<base_type>(borrowed ? diff + _BASE : diff);
+		}
+		long long top = static_cast<long long>(u[reverse_j + n]) - static_cast<long long>(carry) - borrowed;
+		u[reverse_j + n] = static_cast<base_type>(top < 0 ? top + _BASE : top);
+
+		// D6. Add back if the estimate was one too large.
+		if (top < 0) {
+			--q_hat;
+			base_type add_carry = 0;
+			for (size_type i = 0; i < n; ++i) {
+				base_type sum = u[reverse_j + i] + v[i] + add_carry;
+				add_carry = sum >= _BASE;
+				u[reverse_j + i] = add_carry ? sum - _BASE : sum;
 			}
+			u[reverse_j + n] = (u[reverse_j + n] + add_carry) % _BASE;
 		}
-		Big_int incomplete_divisible;
-		incomplete_divisible._data = _multiply_data(_rhs_data, Big_int(quotient)._data);
-		ret -= incomplete_divisible;
+		quotient[reverse_j] = static_cast<base_type>(q_hat);
+	}
+	_delete_leading_zeros(quotient);
+
+	// D8. Unnormalize the remainder.
+	u.resize(n);
+	_delete_leading_zeros(u);
+	_divide_by_word(u, factor);
+	return { quotient, u };
+}
+
+std::pair<Big_int::container_type, Big_int::container_type>
+Big_int::_newton_divmod(const container_type& _lhs_data,
+						const container_type& _rhs_data)
+{
+	// Scale the divisor to a normalized n limbs with the dividend below _BASE^(2 * n),
+	// then the quotient estimate (dividend * reciprocal) / _BASE^(2 * n) is at most 2 too small.
+	size_type shift = _lhs_data.size() + 1 > 2 * _rhs_data.size() ?
+		_lhs_data.size() + 1 - 2 * _rhs_data.size() :
+		0;
+	base_type factor = _BASE / (_rhs_data.back() + 1);
+	container_type divisor = _rhs_data;
+	_multiply_by_word(divisor, factor);
+	_shift_left_limbs(divisor, shift);
+	container_type dividend = _lhs_data;
+	_multiply_by_word(dividend, factor);
+	_shift_left_limbs(dividend, shift);
+
+	container_type quotient = _multiply_data(dividend, _reciprocal(divisor));
+	_shift_right_limbs(quotient, 2 * divisor.size());
+	container_type remainder = _lhs_data;
+	_subtract(remainder, _multiply_data(quotient, _rhs_data));
+	while (_veccmp(remainder, _rhs_data) != -1) {
+		_subtract(remainder, _rhs_data);
+		_add_shifted(quotient, container_type(1, 1), 0);
+	}
+	return { quotient, remainder };
+}
+
+Big_int::container_type Big_int::_reciprocal(const container_type& _data)
+{
+	size_type n = _data.size();
+	Big_int power;
+	power._data.assign(2 * n + 1, 0);
+	power._data.back() = 1;
+	if (n < std::max<std::size_t>(newton_division_threshold, 4)) {
+		return _schoolbook_divmod(power._data, _data).first;
+	}
+
+	// The reciprocal of the top h limbs is correct to about 2 * h - n limbs after one step.
+	size_type h = n / 2 + 1;
+	Big_int x;
+	x._data = _reciprocal(container_type(_data.end() - h, _data.end()));
+	_shift_left_limbs(x._data, n - h);
+
+	// x += x * (_BASE^(2 * n) - d * x) / _BASE^(2 * n)
+	Big_int d;
+	d._data = _data;
+	Big_int correction = x * (power - d * x);
+	_shift_right_limbs(correction._data, 2 * n);
+	if (!correction) {
+		correction._sign = false;
 	}
-	return ret._data;
+	x += correction;
+
+	Big_int remainder = power - d * x;
+	while (remainder < 0) {
+		--x;
+		remainder += d;
+	}
+	while (remainder >= d) {
+		++x;
+		remainder -= d;
+	}
+	return x._data;
 }
 //----------------------------------------------------------------
 
 //--------------------Non-static functions------------------------
-void Big_int::_assign_number(size_type _pos, base_type _number)
+unsigned long long Big_int::_binary_gcd(unsigned long long _lhs, unsigned long long _rhs)
 {
-	if (_pos < _data.size()) {
-		_data[_pos] = _number;
+	if (_lhs == 0 or _rhs == 0) {
+		return _lhs | _rhs;
+	}
+	int shift = std::countr_zero(_lhs | _rhs);
+	_lhs >>= std::countr_zero(_lhs);
+	while (_rhs != 0) {
+		_rhs >>= std::countr_zero(_rhs);
+		if (_lhs > _rhs) {
+			std::swap(_lhs, _rhs);
+		}
+		_rhs -= _lhs;
+	}
+	return _lhs << shift;
+}
+
+std::uint64_t Big_int::_mix(std::uint64_t _lhs, std::uint64_t _rhs) noexcept
+{
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 product = static_cast<unsigned __int128>(_lhs) * _rhs;
+	return static_cast<std::uint64_t>(product >> 64) ^ static_cast<std::uint64_t>(product);
+#else
+	std::uint64_t lhs_high = _lhs >> 32, lhs_low = _lhs & 0xFFFF'FFFF;
+	std::uint64_t rhs_high = _rhs >> 32, rhs_low = _rhs & 0xFFFF'FFFF;
+	std::uint64_t low = lhs_low * rhs_low;
+	std::uint64_t middle1 = lhs_high * rhs_low;
+	std::uint64_t middle2 = lhs_low * rhs_high;
+	std::uint64_t high = lhs_high * rhs_high;
+	std::uint64_t carry = ((low >> 32) + (middle1 & 0xFFFF'FFFF) + (middle2 & 0xFFFF'FFFF)) >> 32;
+	return (high + (middle1 >> 32) + (middle2 >> 32) + carry) ^ (_lhs * _rhs);
+#endif
+}
+
+unsigned long long Big_int::_to_ull(const Big_int& _number)
+{
+	unsigned long long ret = 0;
+	for (size_type i = _number._data.size(); i != 0; --i) {
+		ret = ret * _BASE + _number._data[i - 1];
+	}
+	return ret;
+}
+
+Big_int::base_type Big_int::_remainder_by_word(const container_type& _data, base_type _divisor)
+{
+	double_base_type remainder = 0;
+	for (size_type i = _data.size(); i != 0; --i) {
+		remainder = (remainder * _BASE + _data[i - 1]) % _divisor;
+	}
+	return static_cast<base_type>(remainder);
+}
+
+Big_int Big_int::_iroot(const Big_int& _number, unsigned long long _degree)
+{
+	size_type size = _number._data.size();
+	if (size == 0) {
+		return 0;
+	}
+	// _number < _BASE^size < 2^(30 * size)
+	if (_degree >= 30 * size) {
+		return 1;
+	}
+
+	// Start from above: if top == floor(_number / _BASE^(shift * _degree)),
+	// then _number < (top + 1) * _BASE^(shift * _degree) <= ((root(top) + 1) * _BASE^shift)^_degree.
+	size_type shift = size / (2 * _degree);
+	Big_int x;
+	if (shift == 0) {
+		// The root is below _BASE^2 and the leading two limbs give it to about 1e-9.
+		double top = size >= 2 ? _number._data[size - 1] * double(_BASE) + _number._data[size - 2] : _number._data[0];
+		double exponent = std::log10(top) + double(_COUNT_ZEROS) * (size >= 2 ? size - 2 : 0);
+		x = static_cast<long long>(std::pow(10.0, exponent / _degree) * (1 + 1e-9)) + 1;
 	}
 	else {
-		_data.push_back(_number);
+		// The root of top has a limb more than half of the root,
+		// so a single iteration almost always gives the root.
+		if (shift > 1) {
+			--shift;
+		}
+		Big_int top = _number;
+		top.shift_limbs(-static_cast<std::ptrdiff_t>(shift * _degree));
+		x = _iroot(top, _degree).add_word(1);
+		x.shift_limbs(static_cast<std::ptrdiff_t>(shift));
+	}
+
+	// x = ((_degree - 1) * x + _number / x^(_degree - 1)) / _degree decreases to the root
+	// and never falls below it, so x is the root once x^_degree <= _number. The check
+	// costs a multiplication, cheaper than the division of one more iteration.
+	Big_int degree = static_cast<long long>(_degree);
+	Big_int power;
+	while (true) {
+		if (_degree != 2) {
+			power = pow(x, _degree - 1);
+		}
+		const Big_int& x_power = _degree == 2 ? x : power;
+		if (x_power * x <= _number) {
+			return x;
+		}
+		Big_int y = _number / x_power;
+		y.add_product(x, degree - 1);
+		y /= degree;
+		x = std::move(y);
 	}
 }
 
-void Big_int::_add(const container_type& _rhs_data)
+void Big_int::_lehmer_gcd(Big_int& _u, Big_int& _v, Big_int* _u_cofactor, Big_int* _v_cofactor)
+{
+	auto limb = [](const Big_int& number, size_type index) -> long long {
+		return index < number._data.size() ? number._data[index] : 0;
+	};
+
+	while (_v) {
+		if (!_u_cofactor and _u._data.size() <= 2) {
+			_u = static_cast<long long>(_binary_gcd(_to_ull(_u), _to_ull(_v)));
+			_v._zeroing();
+			return;
+		}
+
+		// Leading two limbs of _u and the limbs of _v at the same position (Knuth, TAOCP vol. 2, 4.5.2, Algorithm L).
+		size_type k = _u._data.size() >= 2 ? _u._data.size() - 2 : 0;
+		long long u_hat = limb(_u, k + 1) * _BASE + limb(_u, k);
+		long long v_hat = limb(_v, k + 1) * _BASE + limb(_v, k);
+		long long a = 1, b = 0, c = 0, d = 1;
+		while (v_hat != 0 and v_hat + c != 0 and v_hat + d != 0) {
+			long long q = (u_hat + a) / (v_hat + c);
+			if (q != (u_hat + b) / (v_hat + d)) {
+				break;
+			}
+			long long t = a - q * c;
+			a = c;
+			c = t;
+			t = b - q * d;
+			b = d;
+			d = t;
+			t = u_hat - q * v_hat;
+			u_hat = v_hat;
+			v_hat = t;
+		}
+
+		if (b == 0) {
+			// The leading limbs cannot predict the quotient: one full division step.
+			auto [q, r] = divmod(_u, _v);
+			_u = std::move(_v);
+			_v = std::move(r);
+			if (_u_cofactor) {
+				Big_int t = *_u_cofactor - q * *_v_cofactor;
+				*_u_cofactor = std::move(*_v_cofactor);
+				*_v_cofactor = std::move(t);
+			}
+		}
+		else {
+			Big_int u = _u * a + _v * b;
+			_v = _u * c + _v * d;
+			_u = std::move(u);
+			if (_u_cofactor) {
+				Big_int x = *_u_cofactor * a + *_v_cofactor * b;
+				*_v_cofactor = *_u_cofactor * c + *_v_cofactor * d;
+				*_u_cofactor = std::move(x);
+			}
+		}
+	}
+}
+
+void Big_int::_add_product(const Big_int& _lhs, const Big_int& _rhs, bool _negate)
 {
-	base_type carry = 0;
-	size_type max_size =
-		_data.size() < _rhs_data.size() ?
-		_data.size() :
-		_rhs_data.size();
-	for (size_type i = 0; i < max_size; ++i) {
-		base_type sum = 0;
-		if (i < _data.size()) {
-			sum += _data[i];
+	if (!_lhs or !_rhs) {
+		return;
+	}
+	bool product_sign = (_lhs._sign != _rhs._sign) != _negate;
+	const container_type& short_data = _lhs._data.size() < _rhs._data.size() ? _lhs._data : _rhs._data;
+	const container_type& long_data = _lhs._data.size() < _rhs._data.size() ? _rhs._data : _lhs._data;
+	if ((*this and _sign != product_sign) or this == &_lhs or this == &_rhs or
+		short_data.size() >= std::max<std::size_t>(karatsuba_threshold, 2)) {
+		Big_int product = _lhs * _rhs;
+		if (_negate) {
+			*this -= product;
 		}
-		if (i < _rhs_data.size()) {
-			sum += _rhs_data[i];
+		else {
+			*this += product;
 		}
-		sum += carry;
+		return;
+	}
 
-		_assign_number(i, sum % _BASE);
-		carry = sum / _BASE;
+	// The magnitudes are added, so the rows of the product go straight into _data.
+	_sign = product_sign;
+	size_type size = short_data.size() + long_data.size();
+	if (_data.size() < size) {
+		_data.resize(size, 0);
 	}
-	if (carry > 0) {
-		_data.push_back(carry);
+	for (size_type i = 0; i < short_data.size(); ++i) {
+		base_type carry = _addmul_1(_data.data() + i, long_data.data(), long_data.size(), short_data[i]);
+		for (size_type j = i + long_data.size(); carry != 0; ++j) {
+			if (j == _data.size()) {
+				_data.push_back(carry);
+				break;
+			}
+			base_type sum = _data[j] + carry;
+			carry = sum >= _BASE;
+			_data[j] = carry ? sum - _BASE : sum;
+		}
 	}
+	_delete_leading_zeros(_data);
+}
+
+void Big_int::_add(const container_type& _rhs_data)
+{
+	_add_shifted(_data, _rhs_data, 0);
 }
 
 void Big_int::_difference(const container_type& _lhs_data, const container_type& _rhs_data)
 {
-	base_type borrowed = 0;
-	for (size_type i = 0; i < _lhs_data.size(); ++i) {
-		base_type diff = _lhs_data[i];
-		base_type rhs_num = i < _rhs_data.size() ? _rhs_data[i] : 0;
-		if (diff > rhs_num) {
-			diff -= rhs_num + borrowed;
-			borrowed = 0;
+	// Limb i of _data is written after limb i of both operands is read.
+	size_type lhs_size = _lhs_data.size();
+	size_type rhs_size = _rhs_data.size();
+	_data.resize(lhs_size);
+	base_type borrowed = _kernels::subtract(_data.data(), _lhs_data.data(), _rhs_data.data(), rhs_size, 0, simd_level);
+	size_type i = rhs_size;
+	for (; i < lhs_size and borrowed != 0; ++i) {
+		borrowed = _lhs_data[i] == 0;
+		_data[i] = borrowed ? _BASE - 1 : _lhs_data[i] - 1;
+	}
+	if (&_data != &_lhs_data) {
+		std::copy(_lhs_data.begin() + i, _lhs_data.end(), _data.begin() + i);
+	}
+	_delete_leading_zeros(_data);
+}
+
+void Big_int::_zeroing()
+{
+	_sign = false;
+	_data.clear();
+}
+
+void Big_int::_add_signed_word(base_type _number, bool _is_negative)
+{
+	if (_sign == _is_negative) {
+		_add_word(_data, _number);
+	}
+	else if (_data.size() > 2 or _to_ull(*this) >= _number) {
+		_subtract_word(_data, _number);
+	}
+	else {
+		double_base_type difference = _number - _to_ull(*this);
+		_data.clear();
+		_add_word(_data, difference);
+		_sign = _is_negative;
+	}
+	if (_data.empty()) {
+		_sign = false;
+	}
+}
+
+Big_int Big_int::_from_binary(	const binary_type::container_type& _limbs,
+								size_type _first,
+								size_type _level,
+								std::vector<Big_int>& _powers)
+{
+	if (_first >= _limbs.size()) {
+		return Big_int();
+	}
+	if (_level == 0) {
+		return Big_int(static_cast<long long>(_limbs[_first]));
+	}
+	size_type half = size_type(1) << (_level - 1);
+	Big_int ret = _from_binary(_limbs, _first + half, _level - 1, _powers);
+	if (ret) {
+		ret *= _powers[_level - 1];
+	}
+	ret += _from_binary(_limbs, _first, _level - 1, _powers);
+	return ret;
+}
+
+Big_int Big_int::_bitwise(const Big_int& _lhs, const Big_int& _rhs, _Bitwise_op _op)
+{
+	auto complement = [](const Big_int& number) {
+		if (!number._sign) {
+			return number.to_binary();
+		}
+		return (-number).sub_word(1).to_binary();
+	};
+	binary_type lhs = complement(_lhs);
+	binary_type rhs = complement(_rhs);
+	bool lhs_negative = _lhs._sign;
+	bool rhs_negative = _rhs._sign;
+	// Only rhs is negative if the signs differ.
+	if (lhs_negative and !rhs_negative) {
+		lhs.swap(rhs);
+		std::swap(lhs_negative, rhs_negative);
+	}
+
+	// ret_negative means the value is ~ret == -(ret + 1).
+	binary_type ret;
+	bool ret_negative = false;
+	switch (_op) {
+	case _Bitwise_op::and_op:
+		if (!rhs_negative) {
+			ret = lhs & rhs;
 		}
-		else if (diff < rhs_num) {
-			diff += _BASE - (rhs_num + borrowed);
-			borrowed = 1;
+		else if (!lhs_negative) {
+			// lhs & ~rhs
+			ret = lhs;
+			ret ^= lhs & rhs;
 		}
 		else {
-			if (borrowed) {
-				diff = _BASE;
-			}
-			diff -= rhs_num + borrowed;
+			// ~lhs & ~rhs == ~(lhs | rhs)
+			ret = lhs | rhs;
+			ret_negative = true;
+		}
+		break;
+	case _Bitwise_op::or_op:
+		if (!rhs_negative) {
+			ret = lhs | rhs;
+		}
+		else if (!lhs_negative) {
+			// lhs | ~rhs == ~(rhs & ~lhs)
+			ret = rhs;
+			ret ^= lhs & rhs;
+			ret_negative = true;
+		}
+		else {
+			// ~lhs | ~rhs == ~(lhs & rhs)
+			ret = lhs & rhs;
+			ret_negative = true;
 		}
-		_assign_number(i, diff);
+		break;
+	case _Bitwise_op::xor_op:
+		ret = lhs ^ rhs;
+		ret_negative = lhs_negative != rhs_negative;
+		break;
 	}
-	_delete_leading_zeros(_data);
-}
 
-void Big_int::_zeroing()
-{
-	_sign = false;
-	_data.clear();
+	Big_int result = from_binary(ret);
+	if (ret_negative) {
+		result.add_word(1);
+		result.negate();
+	}
+	return result;
 }
 //----------------------------------------------------------------
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -228,7 +1143,7 @@ std::ostream& operator<<(std::ostream& os, const Big_int& bi)
 std::istream& operator>>(std::istream& is, Big_int& bi)
 {
 	std::string str_number;
-	std::cin >> str_number;
+	is >> str_number;
 	bi = Big_int(str_number);
 	return is;
 }
@@ -237,6 +1152,23 @@ Big_int::Big_int()
 	: _sign(false)
 	, _data() {}
 
+Big_int::Big_int(Big_int&& bi) noexcept
+	: _sign(bi._sign)
+	, _data(std::move(bi._data))
+{
+	bi._sign = false;
+}
+
+Big_int& Big_int::operator=(Big_int&& bi)
+{
+	if (this != &bi) {
+		_sign = bi._sign;
+		_data = std::move(bi._data);
+		bi._sign = false;
+	}
+	return *this;
+}
+
 Big_int::Big_int(long long number) : _sign(number < 0 ? true : false)
 {
 	if (number != 0) {
@@ -252,27 +1184,11 @@ Big_int::Big_int(long long number) : _sign(number < 0 ? true : false)
 	}
 }
 
-Big_int::Big_int(const std::string& str) : _sign(str.front() == '-' ? true : false)
+Big_int::Big_int(const std::string& str)
 {
-	using str_size = std::string::size_type;
-	str_size shift = _sign or str.front() == '+';
-	while (str[shift] == '0') {
-		++shift;
-	}
-
-	if (shift == str.size()) {
-		_sign = false; // Zero cannot be negative
-	}
-	else {
-		str_size len_past_num = (str.size() - shift) % _COUNT_ZEROS;
-		str_size len_part_str = (str.size() - shift) / _COUNT_ZEROS;
-		for (str_size i = 0; i < len_part_str; ++i) {
-			str_size reverse_i = str.size() - (i + 1) * _COUNT_ZEROS;
-			_data.push_back(std::stoul(str.substr(reverse_i, _COUNT_ZEROS)));
-		}
-		if (len_past_num != 0) {
-			_data.push_back(std::stoul(str.substr(shift, len_past_num)));
-		}
+	auto [ptr, ec] = from_chars(str.data(), str.data() + str.size(), *this);
+	if (ec != std::errc() or ptr != str.data() + str.size()) {
+		throw "Invalid number";
 	}
 }
 
@@ -332,7 +1248,12 @@ Big_int& Big_int::operator*=(const Big_int& rhs)
 	}
 	else if (*this) {
 		_sign = _sign != rhs._sign;
-		_data = _multiply_data(_data, rhs._data);
+		if (rhs._data.size() == 1) {
+			_multiply_by_word(_data, rhs._data.front());
+		}
+		else {
+			_data = _multiply_data(_data, rhs._data);
+		}
 	}
 	return *this;
 }
@@ -347,7 +1268,7 @@ Big_int& Big_int::operator/=(const Big_int& rhs)
 	}
 	else if (*this) {
 		_sign = _sign != rhs._sign;
-		_data = _divide_data(_data, rhs._data);
+		_data = _divmod_data(_data, rhs._data).first;
 	}
 	return *this;
 }
@@ -358,50 +1279,221 @@ Big_int& Big_int::operator%=(const Big_int& rhs)
 		throw "Division by zero";
 	}
 	else if (*this) {
-		container_type remainder = _take_remainder_data(_data, rhs._data);
-		if (remainder.empty()) {
+		_data = std::move(_divmod_data(_data, rhs._data).second);
+		if (_data.empty()) {
 			_zeroing();
 		}
-		else {
-			_data = remainder;
+	}
+	return *this;
+}
+
+Big_int& Big_int::add_product(const Big_int& lhs, const Big_int& rhs)
+{
+	_add_product(lhs, rhs, false);
+	return *this;
+}
+
+Big_int& Big_int::sub_product(const Big_int& lhs, const Big_int& rhs)
+{
+	_add_product(lhs, rhs, true);
+	return *this;
+}
+
+Big_int& Big_int::mul_word(word_type number)
+{
+	_multiply_by_word(_data, number);
+	if (_data.empty()) {
+		_sign = false;
+	}
+	return *this;
+}
+
+Big_int& Big_int::add_word(word_type number)
+{
+	_add_signed_word(number, false);
+	return *this;
+}
+
+Big_int& Big_int::sub_word(word_type number)
+{
+	_add_signed_word(number, true);
+	return *this;
+}
+
+long long Big_int::divmod_word(word_type divisor)
+{
+	if (divisor == 0) {
+		throw "Division by zero";
+	}
+	long long remainder = _divide_by_word(_data, divisor);
+	if (_sign) {
+		remainder = -remainder;
+	}
+	if (_data.empty()) {
+		_sign = false;
+	}
+	return remainder;
+}
+
+Big_int& Big_int::shift_limbs(std::ptrdiff_t shift)
+{
+	if (shift >= 0) {
+		_shift_left_limbs(_data, static_cast<size_type>(shift));
+	}
+	else {
+		_shift_right_limbs(_data, static_cast<size_type>(-shift));
+		if (_data.empty()) {
+			_sign = false;
+		}
+	}
+	return *this;
+}
+
+Big_int& Big_int::operator<<=(std::size_t shift)
+{
+	if (_data.empty() or shift == 0) {
+		return *this;
+	}
+	if (shift > _SMALL_LEFT_SHIFT) {
+		return *this *= pow(Big_int(2), shift);
+	}
+	for (; shift >= 31; shift -= 31) {
+		_multiply_by_word(_data, base_type(1) << 31);
+	}
+	if (shift != 0) {
+		_multiply_by_word(_data, base_type(1) << shift);
+	}
+	return *this;
+}
+
+Big_int& Big_int::operator>>=(std::size_t shift)
+{
+	if (_data.empty() or shift == 0) {
+		return *this;
+	}
+	bool is_negative = _sign;
+	bool is_inexact = false;
+	// Every limb is below 2^30.
+	if (shift / 30 >= _data.size()) {
+		_data.clear();
+		is_inexact = true;
+	}
+	else if (shift > _SMALL_RIGHT_SHIFT) {
+		// x / 2^shift == x * 5^shift / 10^shift, and 10^shift is a shift
+		// by limbs once shift is a multiple of _COUNT_ZEROS.
+		unsigned bits = shift % _COUNT_ZEROS;
+		if (bits != 0) {
+			is_inexact = _divide_by_word(_data, base_type(1) << bits) != 0;
+			shift -= bits;
 		}
+		size_type limbs = shift / _COUNT_ZEROS;
+		_data = _multiply_data(_data, pow(Big_int(5), shift)._data);
+		is_inexact |= std::any_of(_data.begin(), _data.begin() + std::min(limbs, _data.size()),
+									[](base_type limb) { return limb != 0; });
+		_shift_right_limbs(_data, limbs);
+	}
+	else {
+		is_inexact = _divide_by_word(_data, base_type(1) << shift) != 0;
+	}
+	if (_data.empty()) {
+		_sign = false;
+	}
+	// Round toward minus infinity.
+	if (is_negative and is_inexact) {
+		sub_word(1);
 	}
 	return *this;
 }
 
-Big_int Big_int::operator+() const
+Big_int& Big_int::operator&=(const Big_int& rhs)
+{
+	return *this = _bitwise(*this, rhs, _Bitwise_op::and_op);
+}
+
+Big_int& Big_int::operator|=(const Big_int& rhs)
+{
+	return *this = _bitwise(*this, rhs, _Bitwise_op::or_op);
+}
+
+Big_int& Big_int::operator^=(const Big_int& rhs)
+{
+	return *this = _bitwise(*this, rhs, _Bitwise_op::xor_op);
+}
+
+Big_int Big_int::operator~() const
+{
+	Big_int ret = -*this;
+	ret.sub_word(1);
+	return ret;
+}
+
+Big_int::binary_type Big_int::to_binary() const
+{
+	return binary_type::from_decimal_limbs(_data.data(), _data.size());
+}
+
+Big_int Big_int::from_binary(const binary_type& magnitude, bool is_negative)
+{
+	const auto& limbs = magnitude.limbs();
+	size_type level = 0;
+	while ((size_type(1) << level) < limbs.size()) {
+		++level;
+	}
+	std::vector<Big_int> powers(1, Big_int(1LL << 32));
+	while (powers.size() < level) {
+		powers.push_back(square(powers.back()));
+	}
+	Big_int ret = _from_binary(limbs, 0, level, powers);
+	if (is_negative) {
+		ret.negate();
+	}
+	return ret;
+}
+
+Big_int Big_int::operator+() const&
 {
 	return *this;
 }
 
-Big_int Big_int::operator-() const
+Big_int Big_int::operator+() &&
+{
+	return std::move(*this);
+}
+
+Big_int Big_int::operator-() const&
 {
 	Big_int ret(*this);
 	ret.negate();
 	return ret;
 }
 
+Big_int Big_int::operator-() &&
+{
+	negate();
+	return std::move(*this);
+}
+
 Big_int& Big_int::operator++()
 {
-	return *this += 1;
+	return add_word(1);
 }
 
 Big_int Big_int::operator++(int)
 {
 	Big_int ret(*this);
-	*this += 1;
+	add_word(1);
 	return ret;
 }
 
 Big_int& Big_int::operator--()
 {
-	return *this -= 1;
+	return sub_word(1);
 }
 
 Big_int Big_int::operator--(int)
 {
 	Big_int ret(*this);
-	*this -= 1;
+	sub_word(1);
 	return ret;
 }
 
@@ -439,21 +1531,41 @@ std::weak_ordering Big_int::operator<=>(const Big_int& rhs) const
 
 std::string Big_int::to_string() const
 {
-	std::string ret = _data.empty() ?
-		"0" :
-		(_sign ? "-" : "") + std::to_string(_data.back());
+	std::string ret(chars_size(), '0');
+	to_chars(ret.data(), ret.data() + ret.size(), *this);
+	return ret;
+}
 
-	for (size_type i = _data.empty() ? 0 : _data.size() - 1; i != 0; --i) {
-		size_type reverse_i = i - 1;
-		size_t count_zeros = _COUNT_ZEROS - _count_digits(_data[reverse_i]);
-		if (count_zeros == 0) {
-			ret += std::to_string(_data[reverse_i]);
-		}
-		else {
-			ret += std::string(count_zeros, '0') + std::to_string(_data[reverse_i]);
-		}
+std::size_t Big_int::chars_size() const
+{
+	if (_data.empty()) {
+		return 1;
 	}
-	return ret;
+	return _sign + (_data.size() - 1) * _COUNT_ZEROS + _count_digits(_data.back());
+}
+
+std::size_t Big_int::hash() const noexcept
+{
+	// Secrets of wyhash.
+	constexpr std::uint64_t secret0 = 0xa076'1d64'78bd'642f;
+	constexpr std::uint64_t secret1 = 0xe703'7ed1'a0b4'28db;
+	constexpr std::uint64_t secret2 = 0x8ebc'6af0'9c88'c6e3;
+
+	std::uint64_t seed = secret0 ^ (static_cast<std::uint64_t>(_sign) << 63);
+	size_type i = 0;
+	for (; i + 4 <= _data.size(); i += 4) {
+		std::uint64_t low = _data[i] | static_cast<std::uint64_t>(_data[i + 1]) << 32;
+		std::uint64_t high = _data[i + 2] | static_cast<std::uint64_t>(_data[i + 3]) << 32;
+		seed = _mix(low ^ secret1, high ^ seed);
+	}
+	if (i != _data.size()) {
+		// The zero padding of the last step is told apart by the size.
+		auto limb = [this](size_type index) -> std::uint64_t {
+			return index < _data.size() ? _data[index] : 0;
+		};
+		seed = _mix((limb(i) | limb(i + 1) << 32) ^ secret1, (limb(i + 2) | limb(i + 3) << 32) ^ seed);
+	}
+	return static_cast<std::size_t>(_mix(seed ^ secret2, _data.size() ^ secret1));
 }
 
 void Big_int::swap(Big_int& other)
@@ -498,21 +1610,29 @@ Big_int::operator int() const
 	return ret;
 }
 
-Big_int operator""_bi(unsigned long long num)
+Big_int operator+(const Big_int& lhs, const Big_int& rhs)
 {
-	return Big_int(static_cast<long long>(num));
+	Big_int ret(lhs);
+	ret += rhs;
+	return ret;
 }
 
-Big_int operator""_bi(const char* str, size_t len)
+Big_int operator+(Big_int&& lhs, const Big_int& rhs)
 {
-	return Big_int(std::string(str, len));
+	lhs += rhs;
+	return std::move(lhs);
 }
 
-Big_int operator+(const Big_int& lhs, const Big_int& rhs)
+Big_int operator+(const Big_int& lhs, Big_int&& rhs)
 {
-	Big_int ret(lhs);
-	ret += rhs;
-	return ret;
+	rhs += lhs;
+	return std::move(rhs);
+}
+
+Big_int operator+(Big_int&& lhs, Big_int&& rhs)
+{
+	lhs += rhs;
+	return std::move(lhs);
 }
 
 Big_int operator-(const Big_int& lhs, const Big_int& rhs)
@@ -522,13 +1642,54 @@ Big_int operator-(const Big_int& lhs, const Big_int& rhs)
 	return ret;
 }
 
+Big_int operator-(Big_int&& lhs, const Big_int& rhs)
+{
+	lhs -= rhs;
+	return std::move(lhs);
+}
+
+Big_int operator-(const Big_int& lhs, Big_int&& rhs)
+{
+	// lhs - rhs == -(rhs - lhs)
+	rhs -= lhs;
+	rhs.negate();
+	return std::move(rhs);
+}
+
+Big_int operator-(Big_int&& lhs, Big_int&& rhs)
+{
+	lhs -= rhs;
+	return std::move(lhs);
+}
+
 Big_int operator*(const Big_int& lhs, const Big_int& rhs)
 {
+	if (&lhs == &rhs) {
+		return square(lhs);
+	}
 	Big_int ret(lhs);
 	ret *= rhs;
 	return ret;
 }
 
+Big_int operator*(Big_int&& lhs, const Big_int& rhs)
+{
+	lhs *= rhs;
+	return std::move(lhs);
+}
+
+Big_int operator*(const Big_int& lhs, Big_int&& rhs)
+{
+	rhs *= lhs;
+	return std::move(rhs);
+}
+
+Big_int operator*(Big_int&& lhs, Big_int&& rhs)
+{
+	lhs *= rhs;
+	return std::move(lhs);
+}
+
 Big_int operator/(const Big_int& lhs, const Big_int& rhs)
 {
 	Big_int ret(lhs);
@@ -536,6 +1697,12 @@ Big_int operator/(const Big_int& lhs, const Big_int& rhs)
 	return ret;
 }
 
+Big_int operator/(Big_int&& lhs, const Big_int& rhs)
+{
+	lhs /= rhs;
+	return std::move(lhs);
+}
+
 Big_int operator%(const Big_int& lhs, const Big_int& rhs)
 {
 	Big_int ret(lhs);
@@ -543,25 +1710,240 @@ Big_int operator%(const Big_int& lhs, const Big_int& rhs)
 	return ret;
 }
 
+Big_int operator%(Big_int&& lhs, const Big_int& rhs)
+{
+	lhs %= rhs;
+	return std::move(lhs);
+}
+
+Big_int operator<<(Big_int lhs, std::size_t shift)
+{
+	lhs <<= shift;
+	return lhs;
+}
+
+Big_int operator>>(Big_int lhs, std::size_t shift)
+{
+	lhs >>= shift;
+	return lhs;
+}
+
+Big_int operator&(const Big_int& lhs, const Big_int& rhs)
+{
+	Big_int ret(lhs);
+	ret &= rhs;
+	return ret;
+}
+
+Big_int operator|(const Big_int& lhs, const Big_int& rhs)
+{
+	Big_int ret(lhs);
+	ret |= rhs;
+	return ret;
+}
+
+Big_int operator^(const Big_int& lhs, const Big_int& rhs)
+{
+	Big_int ret(lhs);
+	ret ^= rhs;
+	return ret;
+}
+
+std::to_chars_result to_chars(char* first, char* last, const Big_int& value)
+{
+	using size_type = Big_int::size_type;
+	std::size_t size = value.chars_size();
+	if (static_cast<std::size_t>(last - first) < size) {
+		return { last, std::errc::value_too_large };
+	}
+
+	char* ptr = first + size;
+	for (size_type i = 0; i + 1 < value._data.size(); ++i) {
+		Big_int::base_type number = value._data[i];
+		for (unsigned char j = 0; j < Big_int::_COUNT_ZEROS; ++j) {
+			*--ptr = static_cast<char>('0' + number % 10);
+			number /= 10;
+		}
+	}
+	Big_int::base_type number = value._data.empty() ? 0 : value._data.back();
+	do {
+		*--ptr = static_cast<char>('0' + number % 10);
+		number /= 10;
+	} while (number != 0);
+	if (value._sign) {
+		*--ptr = '-';
+	}
+	return { first + size, std::errc() };
+}
+
+std::from_chars_result from_chars(const char* first, const char* last, Big_int& value)
+{
+	const char* ptr = first;
+	bool sign = false;
+	if (ptr != last and (*ptr == '-' or *ptr == '+')) {
+		sign = *ptr == '-';
+		++ptr;
+	}
+	const char* digits_first = ptr;
+	while (ptr != last and *ptr >= '0' and *ptr <= '9') {
+		++ptr;
+	}
+	if (ptr == digits_first) {
+		return { first, std::errc::invalid_argument };
+	}
+	while (digits_first != ptr and *digits_first == '0') {
+		++digits_first;
+	}
+
+	value._data.clear();
+	value._data.reserve((ptr - digits_first + Big_int::_COUNT_ZEROS - 1) / Big_int::_COUNT_ZEROS);
+	for (const char* chunk_last = ptr; chunk_last != digits_first; ) {
+		const char* chunk_first = chunk_last - std::min<std::ptrdiff_t>(Big_int::_COUNT_ZEROS, chunk_last - digits_first);
+		Big_int::base_type number = 0;
+		for (const char* it = chunk_first; it != chunk_last; ++it) {
+			number = number * 10 + static_cast<Big_int::base_type>(*it - '0');
+		}
+		value._data.push_back(number);
+		chunk_last = chunk_first;
+	}
+	value._sign = sign and !value._data.empty(); // Zero cannot be negative
+	return { ptr, std::errc() };
+}
+
+std::pair<Big_int, Big_int> divmod(const Big_int& lhs, const Big_int& rhs)
+{
+	if (!rhs) {
+		throw "Division by zero";
+	}
+	auto [quotient_data, remainder_data] = Big_int::_divmod_data(lhs._data, rhs._data);
+	std::pair<Big_int, Big_int> ret;
+	ret.first._data = std::move(quotient_data);
+	ret.first._sign = ret.first and lhs._sign != rhs._sign;
+	ret.second._data = std::move(remainder_data);
+	ret.second._sign = ret.second and lhs._sign;
+	return ret;
+}
+
+Big_int square(Big_int number)
+{
+	number._sign = false;
+	number._data = Big_int::_square_data(number._data);
+	return number;
+}
+
+Big_int pow(Big_int base, unsigned long long exponent)
+{
+	Big_int ret = 1;
+	while (exponent != 0) {
+		if (exponent & 1) {
+			ret *= base;
+		}
+		exponent >>= 1;
+		if (exponent != 0) {
+			base = square(std::move(base));
+		}
+	}
+	return ret;
+}
+
 Big_int gcd(Big_int m, Big_int n)
 {
-	if (!m and !n) {
-		return 0;
+	m._sign = false;
+	n._sign = false;
+	if (m < n) {
+		m.swap(n);
+	}
+	Big_int::_lehmer_gcd(m, n, nullptr, nullptr);
+	return m;
+}
+
+std::tuple<Big_int, Big_int, Big_int> xgcd(const Big_int& a, const Big_int& b)
+{
+	// u == u_cofactor * |a| + y * |b| for some y, the same for v.
+	Big_int u = a;
+	Big_int v = b;
+	u._sign = false;
+	v._sign = false;
+	Big_int u_cofactor = 1;
+	Big_int v_cofactor = 0;
+	if (u < v) {
+		u.swap(v);
+		u_cofactor.swap(v_cofactor);
+	}
+	Big_int::_lehmer_gcd(u, v, &u_cofactor, &v_cofactor);
+
+	Big_int x = std::move(u_cofactor);
+	Big_int y = b ? (u - x * (a._sign ? -a : a)) / (b._sign ? -b : b) : Big_int(0);
+	if (a._sign) {
+		x.negate();
 	}
-	else if (!m) {
-		return n;
+	if (b._sign) {
+		y.negate();
 	}
-	else if (!n) {
-		return m;
+	return { std::move(u), std::move(x), std::move(y) };
+}
+
+Big_int isqrt(const Big_int& number)
+{
+	if (number < 0) {
+		throw "Square root of a negative number";
 	}
+	return iroot(number, 2);
+}
 
-	while (m and n) {
-		if (m > n) {
-			m %= n;
+Big_int iroot(const Big_int& number, unsigned long long degree)
+{
+	if (degree == 0) {
+		throw "Zero degree of a root";
+	}
+	else if (degree == 1) {
+		return number;
+	}
+	else if (number._sign) {
+		if (degree % 2 == 0) {
+			throw "Even root of a negative number";
 		}
-		else {
-			n %= m;
+		return -Big_int::_iroot(-number, degree);
+	}
+	return Big_int::_iroot(number, degree);
+}
+
+bool is_perfect_square(const Big_int& number)
+{
+	// is_square[m][r] tells whether r is a square modulo m, for m < 65.
+	static const auto is_square = [] {
+		std::array<std::array<bool, 65>, 4> ret = {};
+		const unsigned int moduli[4] = { 64, 63, 65, 11 };
+		for (int i = 0; i < 4; ++i) {
+			for (unsigned int r = 0; r < moduli[i]; ++r) {
+				ret[i][r * r % moduli[i]] = true;
+			}
 		}
+		return ret;
+	}();
+
+	if (number._sign) {
+		return false;
+	}
+	else if (!number) {
+		return true;
+	}
+	// 64 divides _BASE, so the lowest limb gives the residue modulo 64.
+	if (!is_square[0][number._data.front() % 64]) {
+		return false;
+	}
+	Big_int::base_type remainder = Big_int::_remainder_by_word(number._data, 63 * 65 * 11);
+	if (!is_square[1][remainder % 63] or !is_square[2][remainder % 65] or !is_square[3][remainder % 11]) {
+		return false;
+	}
+	Big_int root = isqrt(number);
+	return square(root) == number;
+}
+
+std::size_t popcount(const Big_int& number)
+{
+	if (number < 0) {
+		throw "Negative number has infinitely many set bits";
 	}
-	return m + n;
+	return number.to_binary().popcount();
 }
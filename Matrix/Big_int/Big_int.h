@@ -1,30 +1,123 @@
 #ifndef BIG_INT_H
 #define BIG_INT_H
 
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <span>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
+#include "Big_int_constant.h"
+#include "Big_uint.h"
+#include "Limb_kernels.h"
+#include "Limb_vector.h"
+
+template <std::size_t Terms>
+class Big_int_sum;
+
 class Big_int
 {
 	friend std::ostream& operator<<(std::ostream& os, const Big_int& bi);
 	friend std::istream& operator>>(std::istream& is, Big_int& bi);
+	friend std::pair<Big_int, Big_int> divmod(const Big_int& lhs, const Big_int& rhs);
+	friend Big_int square(Big_int number);
+	friend Big_int gcd(Big_int m, Big_int n);
+	friend std::tuple<Big_int, Big_int, Big_int> xgcd(const Big_int& a, const Big_int& b);
+	friend Big_int iroot(const Big_int& number, unsigned long long degree);
+	friend bool is_perfect_square(const Big_int& number);
+	friend class Modular_context;
+	template <std::size_t Terms>
+	friend class Big_int_sum;
+	friend std::to_chars_result to_chars(char* first, char* last, const Big_int& value);
+	friend std::from_chars_result from_chars(const char* first, const char* last, Big_int& value);
+	friend std::size_t serialized_size(const Big_int& value);
+	friend std::size_t serialize(const Big_int& value, std::span<std::byte> out);
+	friend std::size_t deserialize(std::span<const std::byte> in, Big_int& value);
 public:
 
 	Big_int();
 	Big_int(const Big_int& bi) = default;
+	/// The moved-from number is zero.
+	Big_int(Big_int&& bi) noexcept;
 	Big_int& operator=(const Big_int& bi) = default;
+	/// Copies if bi is stored in another memory resource, see Scoped_limb_arena.
+	Big_int& operator=(Big_int&& bi);
 	Big_int(long long number);
 	explicit Big_int(const std::string& str);
+	/// Copy the limbs of a value computed at compile time, without parsing.
+	template <std::size_t Limbs>
+	Big_int(const Big_int_constant<Limbs>& number);
 
 	Big_int& operator+=(const Big_int& rhs);
 	Big_int& operator-=(const Big_int& rhs);
+	/// a *= a squares a.
 	Big_int& operator*=(const Big_int& rhs);
 	Big_int& operator/=(const Big_int& rhs);
 	Big_int& operator%=(const Big_int& rhs);
 
-	[[nodiscard]] Big_int operator+() const;
-	[[nodiscard]] Big_int operator-() const;
+	/// Fused (*this += lhs * rhs) and (*this -= lhs * rhs).
+	/// Below karatsuba_threshold the partial products are accumulated
+	/// directly in *this when the signs allow it, without a temporary.
+	Big_int& add_product(const Big_int& lhs, const Big_int& rhs);
+	Big_int& sub_product(const Big_int& lhs, const Big_int& rhs);
+
+	/// Machine word of the single-word operations below.
+	using word_type = unsigned int;
+
+	/// In-place operations with one word in O(n), without allocation
+	/// unless the number grows past its capacity.
+	/// Similar to (*this *= number), (*this += number) and (*this -= number).
+	Big_int& mul_word(word_type number);
+	Big_int& add_word(word_type number);
+	Big_int& sub_word(word_type number);
+
+	/// Similar to (*this /= divisor) rounding toward zero.
+	/// Return the remainder, it has the sign of *this like operator%=.
+	/// Throw if divisor is zero.
+	long long divmod_word(word_type divisor);
+
+	/// Similar to (*this *= _BASE^shift) for a positive shift
+	/// and to (*this /= _BASE^-shift) for a negative one.
+	Big_int& shift_limbs(std::ptrdiff_t shift);
+
+	/// Similar to (*this *= 2^shift) and to floor(*this / 2^shift), so a negative
+	/// number shifts like in two's complement: -1 >> 1 == -1.
+	/// Short shifts are O(n) passes of word multiplication or division.
+	/// Longer ones multiply by pow(2, shift), or by pow(5, shift) followed
+	/// by a shift of limbs since 2^-shift == 5^shift / 10^shift.
+	Big_int& operator<<=(std::size_t shift);
+	Big_int& operator>>=(std::size_t shift);
+
+	/// Bitwise operations with two's complement semantics: a negative number
+	/// has infinitely many leading ones, ~x == -x - 1.
+	/// The limbs are base 10^9, so each operation converts both operands to
+	/// binary_type and the result back, O(M(n) log n) for M(n) multiplication.
+	/// Keep a binary_type for a sequence of bitwise operations on the same numbers.
+	Big_int& operator&=(const Big_int& rhs);
+	Big_int& operator|=(const Big_int& rhs);
+	Big_int& operator^=(const Big_int& rhs);
+	[[nodiscard]] Big_int operator~() const;
+
+	/// Binary view of the absolute value. The base 10^9 limbs of Big_int are
+	/// exactly the decimal chunks of binary_type, so the conversion is the
+	/// divide and conquer of Basic_big_uint::from_decimal_limbs.
+	using binary_type = Basic_big_uint<std::uint32_t>;
+	[[nodiscard]] binary_type to_binary() const;
+	/// Return -magnitude if is_negative, magnitude otherwise.
+	/// Halves of magnitude are converted recursively and joined by one multiplication.
+	static Big_int from_binary(const binary_type& magnitude, bool is_negative = false);
+
+	[[nodiscard]] Big_int operator+() const&;
+	[[nodiscard]] Big_int operator+() &&;
+	[[nodiscard]] Big_int operator-() const&;
+	[[nodiscard]] Big_int operator-() &&;
 
 	Big_int& operator++();
 	Big_int operator++(int);
@@ -36,19 +129,58 @@ public:
 	std::weak_ordering operator<=>(const Big_int& rhs) const;
 
 	[[nodiscard]] std::string to_string() const;
+	/// Number of characters written by to_string() and to_chars().
+	[[nodiscard]] std::size_t chars_size() const;
+	/// Hash of the sign and of the limbs, 16 bytes per step mixed like wyhash
+	/// by folding a 128-bit product. Equal numbers have equal hashes.
+	[[nodiscard]] std::size_t hash() const noexcept;
 	void swap(Big_int& other);
 	Big_int& negate();
 
 	explicit operator bool() const;
 	explicit operator int() const;
 
+	/// Operand sizes (in limbs) from which _multiply_data switches
+	/// from schoolbook to Karatsuba and from Karatsuba to Toom-3.
+	/// Default values are tuned by benchmark/benchmark.cpp.
+	static std::size_t karatsuba_threshold;
+	static std::size_t toom3_threshold;
+
+	/// Size of the shorter operand (in limbs) from which _multiply_data
+	/// uses the number-theoretic transform.
+	static std::size_t ntt_threshold;
+
+	/// Size of the divisor and of the quotient (in limbs) from which
+	/// operator/= and operator%= divide by the Newton reciprocal.
+	static std::size_t newton_division_threshold;
+
+	/// Total number of threads of one multiplication, 1 disables the parallel path.
+	/// Products whose shorter operand has at least parallel_threshold limbs
+	/// compute their independent parts concurrently: the three transforms of
+	/// the NTT, the Karatsuba and Toom-3 subproducts and the chunks of unbalanced
+	/// operands. The result does not depend on the number of threads.
+	/// Products run on the calling thread while a Scoped_limb_arena is installed.
+	static std::size_t thread_count;
+	static std::size_t parallel_threshold;
+
+	/// Instruction set of addition, subtraction and comparison of limbs.
+	/// Defaults to supported_simd_level(), a higher level must not be set.
+	static Simd_level simd_level;
+
 private:
 	using base_type = unsigned int;
 	using double_base_type = unsigned long long;
-	using container_type = std::vector<base_type>;
+	/// Values below _BASE^_INLINE_LIMBS are stored without heap allocation.
+	static constexpr std::size_t _INLINE_LIMBS = 4;
+	using container_type = Limb_vector<base_type, _INLINE_LIMBS>;
 	using size_type = container_type::size_type;
 	static constexpr base_type _BASE = 1'000'000'000;
 	static constexpr unsigned char _COUNT_ZEROS = 9;
+	using _kernels = Limb_kernels<_BASE>;
+	/// Longest shifts (in bits) done by word operations, see operator<<=.
+	/// Division by a word is slower than multiplication, so right shifts switch earlier.
+	static constexpr std::size_t _SMALL_LEFT_SHIFT = 3 * 31;
+	static constexpr std::size_t _SMALL_RIGHT_SHIFT = 31;
 
 	bool _sign;
 	container_type _data;
@@ -64,32 +196,255 @@ private:
 	/// Positive value if _lhs_data > _rhs_data
 	static int _veccmp(const container_type& _lhs_data, const container_type& _rhs_data);
 
+	/// Return _data[_first, _last) without leading zeros.
+	static container_type _slice(const container_type& _data, size_type _first, size_type _last);
+
+	/// Similar to (_data += _rhs_data * _BASE^_shift)
+	static void _add_shifted(container_type& _data, const container_type& _rhs_data, size_type _shift);
+
+	/// Similar to (_data -= _rhs_data). Requires _data >= _rhs_data.
+	static void _subtract(container_type& _data, const container_type& _rhs_data);
+
+	/// Similar to (_data /= _divisor). Return the remainder.
+	static base_type _divide_by_word(container_type& _data, base_type _divisor);
+
+	/// Similar to (_result[0, _size) += _data[0, _size) * _number).
+	/// Return the carry out of _result[_size - 1], it is less than _BASE.
+	static base_type _addmul_1(base_type* _result, const base_type* _data, size_type _size, base_type _number);
+
+	/// Similar to (_data *= _number).
+	static void _multiply_by_word(container_type& _data, base_type _number);
+
+	/// Similar to (_data += _number).
+	static void _add_word(container_type& _data, double_base_type _number);
+
+	/// Similar to (_data -= _number). Requires _data >= _number.
+	static void _subtract_word(container_type& _data, double_base_type _number);
+
+	/// Similar to (_data *= _BASE^_shift).
+	static void _shift_left_limbs(container_type& _data, size_type _shift);
+
+	/// Similar to (_data /= _BASE^_shift).
+	static void _shift_right_limbs(container_type& _data, size_type _shift);
+
+	/// Threads started by _parallel_for and not finished yet, in all multiplications.
+	static std::atomic<std::size_t> _active_threads;
+
+	/// True if a product with operands of _size limbs may use several threads,
+	/// never while a memory resource is installed by current_limb_resource().
+	static bool _is_parallel(size_type _size);
+
+	/// Reserve up to _count threads within thread_count. Return the number reserved.
+	static size_type _acquire_threads(size_type _count);
+
+	/// Call _task(i) for each i in [0, _count), on several threads if the
+	/// operand size _size reaches parallel_threshold and threads are available.
+	/// The first exception thrown by a task is rethrown after all of them finish.
+	static void _parallel_for(size_type _count, size_type _size, const std::function<void(size_type)>& _task);
+
+	/// Select the multiplication algorithm by the operand sizes.
+	/// Square if both operands are the same object.
 	static container_type _multiply_data(const container_type& _lhs_data, const container_type& _rhs_data);
-	static container_type _divide_data(const container_type& _lhs_data, const container_type& _rhs_data);
-	static container_type _take_remainder_data(const container_type& _lhs_data, const container_type& _rhs_data);
+	static container_type _schoolbook_multiply(const container_type& _lhs_data, const container_type& _rhs_data);
+	static container_type _karatsuba_multiply(const container_type& _lhs_data, const container_type& _rhs_data);
+	static container_type _toom3_multiply(const container_type& _lhs_data, const container_type& _rhs_data);
+
+	/// Select the squaring algorithm by the size like _multiply_data.
+	static container_type _square_data(const container_type& _data);
+	/// Each cross product _data[i] * _data[j] is computed once and doubled.
+	static container_type _schoolbook_square(const container_type& _data);
+	static container_type _karatsuba_square(const container_type& _data);
+
+	/// Primes of the form c * 2^k + 1 with the primitive root 3.
+	/// The product of the primes bounds the coefficients of the convolution.
+	static constexpr base_type _NTT_PRIMES[3] = { 998'244'353, 167'772'161, 469'762'049 };
+	static constexpr base_type _NTT_ROOT = 3;
+	/// Maximum transform length supported by all _NTT_PRIMES.
+	static constexpr size_type _NTT_MAX_SIZE = size_type(1) << 23;
+
+	static base_type _pow_mod(base_type _number, double_base_type _power, base_type _mod);
+
+	/// In-place transform of _data (size is a power of two) modulo _mod.
+	static void _ntt(container_type& _data, bool _invert, base_type _mod);
+
+	/// Convolution modulo each of _NTT_PRIMES, then Chinese remaindering into base _BASE.
+	static container_type _ntt_multiply(const container_type& _lhs_data, const container_type& _rhs_data);
+
+	/// Multiply by splitting _long_data into chunks of _short_data.size() limbs.
+	static container_type _unbalanced_multiply(const container_type& _long_data, const container_type& _short_data);
+	/// Return the quotient and the remainder of _lhs_data / _rhs_data.
+	/// Select the division algorithm by the operand sizes.
+	static std::pair<container_type, container_type>
+	_divmod_data(const container_type& _lhs_data, const container_type& _rhs_data);
 
-	/// Assign _number to _data[_pos].
-	/// If ( _pos < _data.size() ) then ( _data.push_back(_number) )
-	void _assign_number(size_type _pos, base_type _number);
+	/// Schoolbook long division (Knuth, TAOCP vol. 2, 4.3.1, Algorithm D).
+	static std::pair<container_type, container_type>
+	_schoolbook_divmod(const container_type& _lhs_data, const container_type& _rhs_data);
+
+	/// Multiply _lhs_data by the reciprocal of _rhs_data computed by Newton iteration.
+	static std::pair<container_type, container_type>
+	_newton_divmod(const container_type& _lhs_data, const container_type& _rhs_data);
+
+	/// Return floor(_BASE^(2 * _data.size()) / _data).
+	/// The leading limb of _data must be at least _BASE / 2.
+	static container_type _reciprocal(const container_type& _data);
+
+	/// Euclid's algorithm for numbers below 2^64 by shifts and subtractions (Stein).
+	static unsigned long long _binary_gcd(unsigned long long _lhs, unsigned long long _rhs);
+
+	/// wyhash mixing: the high and low halves of the 128-bit product xor-ed.
+	static std::uint64_t _mix(std::uint64_t _lhs, std::uint64_t _rhs) noexcept;
+
+	/// Return |_number| if it is below 2^64, which holds for at most two limbs.
+	static unsigned long long _to_ull(const Big_int& _number);
+
+	/// Lehmer's algorithm: replace _u, _v (_u >= _v >= 0) by gcd(_u, _v) and zero.
+	/// Quotient steps are batched on the leading two limbs, then applied to
+	/// the full numbers as one linear combination.
+	/// If _u_cofactor is not null, the same steps are applied to the cofactors
+	/// (_u_cofactor, _v_cofactor) so that _u == _u_cofactor * a (mod b) holds
+	/// for the initial _u == a, _v == b, _u_cofactor == 1, _v_cofactor == 0.
+	/// Otherwise numbers of at most two limbs finish by _binary_gcd.
+	static void _lehmer_gcd(Big_int& _u, Big_int& _v, Big_int* _u_cofactor, Big_int* _v_cofactor);
+
+	/// floor(_number^(1 / _degree)) for _number >= 0 and _degree >= 2 by Newton's
+	/// iteration from above. The starting value is the root of the leading limbs,
+	/// found recursively, so the precision doubles with every level and a few
+	/// full-size iterations finish the root.
+	static Big_int _iroot(const Big_int& _number, unsigned long long _degree);
+
+	/// Return _data mod _divisor without changing _data.
+	static base_type _remainder_by_word(const container_type& _data, base_type _divisor);
+
+	/// Value of _limbs[_first, _first + 2^_level) of a binary_type,
+	/// _powers[k] == 2^(32 * 2^k).
+	static Big_int _from_binary(const binary_type::container_type& _limbs, size_type _first, size_type _level,
+								std::vector<Big_int>& _powers);
+
+	/// Two's complement _lhs & _rhs, _lhs | _rhs or _lhs ^ _rhs.
+	/// A negative operand x is ~(|x| - 1), the result is decoded the same way.
+	enum class _Bitwise_op { and_op, or_op, xor_op };
+	static Big_int _bitwise(const Big_int& _lhs, const Big_int& _rhs, _Bitwise_op _op);
+
+	/// Similar to (*this += _lhs * _rhs) or (*this -= _lhs * _rhs) if _negate.
+	void _add_product(const Big_int& _lhs, const Big_int& _rhs, bool _negate);
 
 	/// Similar to (_data += _rhs_data)
 	void _add(const container_type& _rhs_data);
 
-	/// Similar to (_data = _lhs_data - _rhs_data)
+	/// Similar to (_data = _lhs_data - _rhs_data). Requires _lhs_data >= _rhs_data.
+	/// Either operand can be _data itself.
 	void _difference(const container_type& _lhs_data, const container_type& _rhs_data);
 
 	void _zeroing();
+
+	/// Similar to (*this += _number) or (*this -= _number) if _is_negative.
+	void _add_signed_word(base_type _number, bool _is_negative);
 };
 
-Big_int operator""_bi(unsigned long long num);
-Big_int operator""_bi(const char* str, size_t len);
+template <>
+struct std::hash<Big_int>
+{
+	std::size_t operator()(const Big_int& number) const noexcept
+	{
+		return number.hash();
+	}
+};
+
+template <std::size_t Limbs>
+Big_int::Big_int(const Big_int_constant<Limbs>& number)
+	: _sign(number.is_negative())
+	, _data(number.size())
+{
+	static_assert(Big_int_constant<Limbs>::BASE == _BASE);
+	std::copy_n(number.data(), number.size(), _data.data());
+}
+
+/// Literals are parsed at compile time into a Big_int_constant in read-only
+/// data, each evaluation only copies its limbs.
+/// An integer literal is not limited to unsigned long long and can be
+/// hexadecimal, binary or octal with ' separators: 0xFFFF'FFFF'FFFF'FFFF'FFFF_bi.
+/// A string literal is optionally signed decimal digits: "-12345"_bi.
+template <char... Chars>
+Big_int operator""_bi()
+{
+	static constexpr char chars[] = { Chars... };
+	// A hexadecimal digit has 4 bits and a limb almost 30.
+	static constexpr auto value = parse_integer_literal<sizeof...(Chars) / 7 + 1>(std::string_view(chars, sizeof(chars)));
+	return value;
+}
 
+template <Big_int_literal_chars Str>
+Big_int operator""_bi()
+{
+	static constexpr std::size_t size = sizeof(Str.chars) - 1;
+	static constexpr Big_int_constant<size / 9 + 1> value(std::string_view(Str.chars, size));
+	return value;
+}
+
+// Overloads for rvalues reuse the limbs of a temporary operand.
 Big_int operator+(const Big_int& lhs, const Big_int& rhs);
+Big_int operator+(Big_int&& lhs, const Big_int& rhs);
+Big_int operator+(const Big_int& lhs, Big_int&& rhs);
+Big_int operator+(Big_int&& lhs, Big_int&& rhs);
+
 Big_int operator-(const Big_int& lhs, const Big_int& rhs);
+Big_int operator-(Big_int&& lhs, const Big_int& rhs);
+Big_int operator-(const Big_int& lhs, Big_int&& rhs);
+Big_int operator-(Big_int&& lhs, Big_int&& rhs);
+
 Big_int operator*(const Big_int& lhs, const Big_int& rhs);
+Big_int operator*(Big_int&& lhs, const Big_int& rhs);
+Big_int operator*(const Big_int& lhs, Big_int&& rhs);
+Big_int operator*(Big_int&& lhs, Big_int&& rhs);
+
 Big_int operator/(const Big_int& lhs, const Big_int& rhs);
+Big_int operator/(Big_int&& lhs, const Big_int& rhs);
+
 Big_int operator%(const Big_int& lhs, const Big_int& rhs);
+Big_int operator%(Big_int&& lhs, const Big_int& rhs);
+
+Big_int operator<<(Big_int lhs, std::size_t shift);
+Big_int operator>>(Big_int lhs, std::size_t shift);
+Big_int operator&(const Big_int& lhs, const Big_int& rhs);
+Big_int operator|(const Big_int& lhs, const Big_int& rhs);
+Big_int operator^(const Big_int& lhs, const Big_int& rhs);
+
+/// Write the decimal representation of value to [first, last) like std::to_chars.
+/// Return { last, std::errc::value_too_large } if value.chars_size() characters do not fit.
+std::to_chars_result to_chars(char* first, char* last, const Big_int& value);
+
+/// Parse an optionally signed decimal number from [first, last) like std::from_chars.
+/// Return { first, std::errc::invalid_argument } if there are no digits.
+std::from_chars_result from_chars(const char* first, const char* last, Big_int& value);
 
+/// Return { lhs / rhs, lhs % rhs } computed by one long division.
+[[nodiscard]] std::pair<Big_int, Big_int> divmod(const Big_int& lhs, const Big_int& rhs);
+
+/// Return number * number with about half of the partial products of multiplication.
+[[nodiscard]] Big_int square(Big_int number);
+
+/// Return base^exponent by repeated squaring.
+[[nodiscard]] Big_int pow(Big_int base, unsigned long long exponent);
+
+/// Return the non-negative greatest common divisor, gcd(0, 0) == 0.
 [[nodiscard]] Big_int gcd(Big_int m, Big_int n);
 
+/// Return { g, x, y } with a * x + b * y == g == gcd(a, b).
+/// If a != 0 then x is the inverse of a / g modulo |b / g| when |b / g| > 1.
+[[nodiscard]] std::tuple<Big_int, Big_int, Big_int> xgcd(const Big_int& a, const Big_int& b);
+
+/// Return floor(sqrt(number)). Throw if number is negative.
+[[nodiscard]] Big_int isqrt(const Big_int& number);
+
+/// Return the integer part of the real root of the given degree, rounded toward zero.
+/// Throw if degree is zero or if it is even and number is negative.
+[[nodiscard]] Big_int iroot(const Big_int& number, unsigned long long degree);
+
+/// Number of set bits of number. Throw if number is negative.
+[[nodiscard]] std::size_t popcount(const Big_int& number);
+
+/// Residues modulo 64, 63, 65 and 11 reject most non-squares before isqrt.
+[[nodiscard]] bool is_perfect_square(const Big_int& number);
+
 #endif
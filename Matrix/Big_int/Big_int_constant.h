@@ -0,0 +1,383 @@
+#ifndef BIG_INT_CONSTANT_H
+#define BIG_INT_CONSTANT_H
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <string_view>
+
+/// Signed integer of at most Limbs limbs in base 10^9, the representation
+/// of Big_int, stored in place so that construction, addition, subtraction,
+/// multiplication and comparisons are usable in constant evaluation.
+/// A constexpr value is computed by the compiler and stored in read-only
+/// data; Big_int is constructed from it by copying the limbs, without
+/// parsing or arithmetic at run time.
+/// Operations whose result does not fit throw "Big_int_constant overflow",
+/// which fails the compilation of a constant expression.
+template <std::size_t Limbs>
+class Big_int_constant
+{
+public:
+	using limb_type = unsigned int;
+	using size_type = std::size_t;
+
+	static constexpr limb_type BASE = 1'000'000'000;
+	static constexpr unsigned char BASE_DIGITS = 9;
+	static_assert(Limbs > 0);
+
+	constexpr Big_int_constant();
+	constexpr Big_int_constant(long long number);
+	/// Optionally signed decimal digits like Big_int(const std::string&).
+	/// Throw "Invalid number" otherwise.
+	constexpr explicit Big_int_constant(std::string_view str);
+
+	constexpr Big_int_constant& operator+=(const Big_int_constant& rhs);
+	constexpr Big_int_constant& operator-=(const Big_int_constant& rhs);
+	constexpr Big_int_constant& operator*=(const Big_int_constant& rhs);
+
+	/// Similar to (*this *= number) and (*this += number) like in Big_int.
+	constexpr Big_int_constant& mul_word(limb_type number);
+	constexpr Big_int_constant& add_word(limb_type number);
+
+	[[nodiscard]] constexpr Big_int_constant operator+() const;
+	[[nodiscard]] constexpr Big_int_constant operator-() const;
+
+	constexpr bool operator==(const Big_int_constant& rhs) const = default;
+	constexpr std::strong_ordering operator<=>(const Big_int_constant& rhs) const;
+
+	constexpr Big_int_constant& negate();
+	constexpr explicit operator bool() const;
+
+	[[nodiscard]] constexpr bool is_negative() const;
+	/// Limbs of the absolute value, least significant first, without leading zeros.
+	[[nodiscard]] constexpr const limb_type* data() const;
+	[[nodiscard]] constexpr size_type size() const;
+
+	// Defined here so that an integer operand converts like for Big_int: x + 1.
+	friend constexpr Big_int_constant operator+(Big_int_constant lhs, const Big_int_constant& rhs)
+	{
+		lhs += rhs;
+		return lhs;
+	}
+
+	friend constexpr Big_int_constant operator-(Big_int_constant lhs, const Big_int_constant& rhs)
+	{
+		lhs -= rhs;
+		return lhs;
+	}
+
+	friend constexpr Big_int_constant operator*(Big_int_constant lhs, const Big_int_constant& rhs)
+	{
+		lhs *= rhs;
+		return lhs;
+	}
+
+private:
+	using double_limb_type = unsigned long long;
+
+	bool _sign;
+	size_type _size;
+	std::array<limb_type, Limbs> _data;	// limbs from _size on are zero
+
+	/// Similar to strcmp from C, on the absolute values.
+	constexpr int _compare_magnitude(const Big_int_constant& _rhs) const;
+
+	/// Similar to (|*this| += |_rhs|).
+	constexpr void _add(const Big_int_constant& _rhs);
+
+	/// Similar to (|*this| = |_lhs| - |_rhs|). Requires |_lhs| >= |_rhs|.
+	constexpr void _difference(const Big_int_constant& _lhs, const Big_int_constant& _rhs);
+
+	/// Similar to (_data.push_back(_limb)). Throw if it does not fit.
+	constexpr void _push_back(limb_type _limb);
+
+	/// Drop leading zero limbs, zero is not negative.
+	constexpr void _normalize();
+};
+
+//++++++++++++++++++++Support functions+++++++++++++++++++++++++++
+template <std::size_t Limbs>
+constexpr int Big_int_constant<Limbs>::_compare_magnitude(const Big_int_constant& _rhs) const
+{
+	if (_size != _rhs._size) {
+		return _size > _rhs._size ? 1 : -1;
+	}
+	for (size_type i = _size; i != 0; --i) {
+		if (_data[i - 1] != _rhs._data[i - 1]) {
+			return _data[i - 1] > _rhs._data[i - 1] ? 1 : -1;
+		}
+	}
+	return 0;
+}
+
+template <std::size_t Limbs>
+constexpr void Big_int_constant<Limbs>::_add(const Big_int_constant& _rhs)
+{
+	limb_type carry = 0;
+	size_type size = std::max(_size, _rhs._size);
+	for (size_type i = 0; i < size; ++i) {
+		limb_type sum = _data[i] + _rhs._data[i] + carry;
+		carry = sum >= BASE;
+		_data[i] = carry ? sum - BASE : sum;
+	}
+	_size = size;
+	if (carry) {
+		_push_back(carry);
+	}
+}
+
+template <std::size_t Limbs>
+constexpr void Big_int_constant<Limbs>::_difference(const Big_int_constant& _lhs, const Big_int_constant& _rhs)
+{
+	limb_type borrowed = 0;
+	for (size_type i = 0; i < _lhs._size; ++i) {
+		limb_type subtrahend = _rhs._data[i] + borrowed;
+		borrowed = _lhs._data[i] < subtrahend;
+		_data[i] = _lhs._data[i] + (borrowed ? BASE : 0) - subtrahend;
+	}
+	_size = _lhs._size;
+	_normalize();
+}
+
+template <std::size_t Limbs>
+constexpr void Big_int_constant<Limbs>::_push_back(limb_type _limb)
+{
+	if (_size == Limbs) {
+		throw "Big_int_constant overflow";
+	}
+	_data[_size++] = _limb;
+}
+
+template <std::size_t Limbs>
+constexpr void Big_int_constant<Limbs>::_normalize()
+{
+	while (_size != 0 and _data[_size - 1] == 0) {
+		--_size;
+	}
+	_sign = _sign and _size != 0;
+}
+
+//++++++++++++++++++++Constructors++++++++++++++++++++++++++++++++
+template <std::size_t Limbs>
+constexpr Big_int_constant<Limbs>::Big_int_constant()
+	: _sign(false)
+	, _size(0)
+	, _data() {}
+
+template <std::size_t Limbs>
+constexpr Big_int_constant<Limbs>::Big_int_constant(long long number) : Big_int_constant()
+{
+	_sign = number < 0;
+	// Negated as unsigned so that the minimum of long long does not overflow.
+	unsigned long long magnitude = _sign ? 0ULL - static_cast<unsigned long long>(number) : number;
+	for (; magnitude != 0; magnitude /= BASE) {
+		_push_back(static_cast<limb_type>(magnitude % BASE));
+	}
+}
+
+template <std::size_t Limbs>
+constexpr Big_int_constant<Limbs>::Big_int_constant(std::string_view str) : Big_int_constant()
+{
+	bool sign = false;
+	if (!str.empty() and (str.front() == '-' or str.front() == '+')) {
+		sign = str.front() == '-';
+		str.remove_prefix(1);
+	}
+	if (str.empty() or !std::all_of(str.begin(), str.end(), [](char c) { return c >= '0' and c <= '9'; })) {
+		throw "Invalid number";
+	}
+	while (str.size() > 1 and str.front() == '0') {
+		str.remove_prefix(1);
+	}
+	for (size_type last = str.size(); last != 0; ) {
+		size_type first = last - std::min<size_type>(BASE_DIGITS, last);
+		limb_type number = 0;
+		for (size_type i = first; i != last; ++i) {
+			number = number * 10 + static_cast<limb_type>(str[i] - '0');
+		}
+		_push_back(number);
+		last = first;
+	}
+	_sign = sign;
+	_normalize();
+}
+
+//++++++++++++++++++++Arithmetic++++++++++++++++++++++++++++++++++
+template <std::size_t Limbs>
+constexpr Big_int_constant<Limbs>& Big_int_constant<Limbs>::operator+=(const Big_int_constant& rhs)
+{
+	if (_sign == rhs._sign) {
+		_add(rhs);
+	}
+	else if (_compare_magnitude(rhs) >= 0) {
+		_difference(*this, rhs);
+	}
+	else {
+		_difference(rhs, *this);
+		_sign = rhs._sign;
+	}
+	return *this;
+}
+
+template <std::size_t Limbs>
+constexpr Big_int_constant<Limbs>& Big_int_constant<Limbs>::operator-=(const Big_int_constant& rhs)
+{
+	return *this += -rhs;
+}
+
+template <std::size_t Limbs>
+constexpr Big_int_constant<Limbs>& Big_int_constant<Limbs>::operator*=(const Big_int_constant& rhs)
+{
+	if (!*this or !rhs) {
+		*this = Big_int_constant();
+		return *this;
+	}
+	if (_size + rhs._size - 1 > Limbs) {
+		throw "Big_int_constant overflow";
+	}
+	// The last limb of the schoolbook product is a carry, so one more is kept.
+	std::array<limb_type, Limbs + 1> product{};
+	for (size_type i = 0; i < _size; ++i) {
+		double_limb_type carry = 0;
+		for (size_type j = 0; j < rhs._size; ++j) {
+			double_limb_type cur = product[i + j] + carry + static_cast<double_limb_type>(_data[i]) * rhs._data[j];
+			product[i + j] = static_cast<limb_type>(cur % BASE);
+			carry = cur / BASE;
+		}
+		product[i + rhs._size] = static_cast<limb_type>(carry);
+	}
+	if (product[Limbs] != 0) {
+		throw "Big_int_constant overflow";
+	}
+	std::copy_n(product.begin(), Limbs, _data.begin());
+	_size = std::min(_size + rhs._size, Limbs);
+	_sign = _sign != rhs._sign;
+	_normalize();
+	return *this;
+}
+
+template <std::size_t Limbs>
+constexpr Big_int_constant<Limbs>& Big_int_constant<Limbs>::mul_word(limb_type number)
+{
+	return *this *= Big_int_constant(static_cast<long long>(number));
+}
+
+template <std::size_t Limbs>
+constexpr Big_int_constant<Limbs>& Big_int_constant<Limbs>::add_word(limb_type number)
+{
+	return *this += Big_int_constant(static_cast<long long>(number));
+}
+
+template <std::size_t Limbs>
+constexpr Big_int_constant<Limbs> Big_int_constant<Limbs>::operator+() const
+{
+	return *this;
+}
+
+template <std::size_t Limbs>
+constexpr Big_int_constant<Limbs> Big_int_constant<Limbs>::operator-() const
+{
+	Big_int_constant ret(*this);
+	ret.negate();
+	return ret;
+}
+
+template <std::size_t Limbs>
+constexpr Big_int_constant<Limbs>& Big_int_constant<Limbs>::negate()
+{
+	_sign = !_sign and _size != 0;
+	return *this;
+}
+
+//++++++++++++++++++++Comparison and access+++++++++++++++++++++++
+template <std::size_t Limbs>
+constexpr std::strong_ordering Big_int_constant<Limbs>::operator<=>(const Big_int_constant& rhs) const
+{
+	if (_sign != rhs._sign) {
+		return _sign ? std::strong_ordering::less : std::strong_ordering::greater;
+	}
+	int cmp = _sign ? rhs._compare_magnitude(*this) : _compare_magnitude(rhs);
+	return cmp <=> 0;
+}
+
+template <std::size_t Limbs>
+constexpr Big_int_constant<Limbs>::operator bool() const
+{
+	return _size != 0;
+}
+
+template <std::size_t Limbs>
+constexpr bool Big_int_constant<Limbs>::is_negative() const
+{
+	return _sign;
+}
+
+template <std::size_t Limbs>
+constexpr const typename Big_int_constant<Limbs>::limb_type* Big_int_constant<Limbs>::data() const
+{
+	return _data.data();
+}
+
+template <std::size_t Limbs>
+constexpr typename Big_int_constant<Limbs>::size_type Big_int_constant<Limbs>::size() const
+{
+	return _size;
+}
+
+//++++++++++++++++++++Literals++++++++++++++++++++++++++++++++++++
+/// Characters of a string literal as a template argument of operator""_bi.
+template <std::size_t Size>
+struct Big_int_literal_chars
+{
+	constexpr Big_int_literal_chars(const char (&str)[Size])
+	{
+		std::copy_n(str, Size, chars);
+	}
+
+	char chars[Size];
+};
+
+/// Value of an integer literal: decimal, 0x hexadecimal, 0b binary or 0 octal
+/// digits with optional ' separators. Throw "Invalid number" otherwise.
+template <std::size_t Limbs>
+constexpr Big_int_constant<Limbs> parse_integer_literal(std::string_view str)
+{
+	unsigned radix = 10;
+	if (str.size() > 2 and str[0] == '0' and (str[1] == 'x' or str[1] == 'X')) {
+		radix = 16;
+		str.remove_prefix(2);
+	}
+	else if (str.size() > 2 and str[0] == '0' and (str[1] == 'b' or str[1] == 'B')) {
+		radix = 2;
+		str.remove_prefix(2);
+	}
+	else if (str.size() > 1 and str[0] == '0') {
+		radix = 8;
+		str.remove_prefix(1);
+	}
+
+	Big_int_constant<Limbs> ret;
+	for (char c : str) {
+		if (c == '\'') {
+			continue;
+		}
+		unsigned digit = radix;
+		if (c >= '0' and c <= '9') {
+			digit = static_cast<unsigned>(c - '0');
+		}
+		else if (c >= 'a' and c <= 'f') {
+			digit = static_cast<unsigned>(c - 'a' + 10);
+		}
+		else if (c >= 'A' and c <= 'F') {
+			digit = static_cast<unsigned>(c - 'A' + 10);
+		}
+		if (digit >= radix) {
+			throw "Invalid number";
+		}
+		ret.mul_word(radix).add_word(digit);
+	}
+	return ret;
+}
+
+#endif
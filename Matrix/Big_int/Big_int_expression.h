@@ -0,0 +1,175 @@
+#ifndef BIG_INT_EXPRESSION_H
+#define BIG_INT_EXPRESSION_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include "Big_int.h"
+
+// Optional lazy evaluation of sums of products:
+//
+//     Big_int r = lazy(a) * b + lazy(c) * d - e;
+//
+// builds a Big_int_sum<3> of references and evaluates it into the single
+// buffer of r by Big_int::add_product, so a schoolbook-sized product never
+// gets its own temporary. The operands must outlive the expression, which
+// holds for an expression assigned in the same statement.
+
+/// Signed term of a sum: *lhs or *lhs * *rhs.
+struct Big_int_term
+{
+	const Big_int* lhs;
+	const Big_int* rhs;	// nullptr for a term without a product
+	bool is_negative;
+};
+
+/// Operand marked for lazy evaluation, see lazy().
+class Lazy_big_int
+{
+public:
+	explicit Lazy_big_int(const Big_int& value) : _value(&value) {}
+
+	[[nodiscard]] const Big_int& value() const { return *_value; }
+
+private:
+	const Big_int* _value;
+};
+
+[[nodiscard]] inline Lazy_big_int lazy(const Big_int& value)
+{
+	return Lazy_big_int(value);
+}
+
+/// Sum of Terms signed terms, evaluated on conversion to Big_int.
+template <std::size_t Terms>
+class Big_int_sum
+{
+public:
+	explicit Big_int_sum(const std::array<Big_int_term, Terms>& terms) : _terms(terms) {}
+
+	[[nodiscard]] const std::array<Big_int_term, Terms>& terms() const { return _terms; }
+
+	operator Big_int() const
+	{
+		// Reserve the size of the largest term once for the whole sum.
+		Big_int::size_type size = 0;
+		for (const auto& term : _terms) {
+			size = std::max(size, term.lhs->_data.size() + (term.rhs ? term.rhs->_data.size() : 0));
+		}
+		Big_int ret;
+		ret._data.reserve(size + 1);
+		for (const auto& term : _terms) {
+			if (term.rhs) {
+				ret._add_product(*term.lhs, *term.rhs, term.is_negative);
+			}
+			else if (term.is_negative) {
+				ret -= *term.lhs;
+			}
+			else {
+				ret += *term.lhs;
+			}
+		}
+		return ret;
+	}
+
+	[[nodiscard]] Big_int_sum<Terms> operator-() const
+	{
+		Big_int_sum<Terms> ret(*this);
+		for (auto& term : ret._terms) {
+			term.is_negative = !term.is_negative;
+		}
+		return ret;
+	}
+
+private:
+	template <std::size_t Other_terms>
+	friend class Big_int_sum;
+
+	std::array<Big_int_term, Terms> _terms;
+};
+
+[[nodiscard]] inline Big_int_sum<1> operator*(Lazy_big_int lhs, const Big_int& rhs)
+{
+	return Big_int_sum<1>({ Big_int_term{ &lhs.value(), &rhs, false } });
+}
+
+[[nodiscard]] inline Big_int_sum<1> operator*(const Big_int& lhs, Lazy_big_int rhs)
+{
+	return Big_int_sum<1>({ Big_int_term{ &lhs, &rhs.value(), false } });
+}
+
+[[nodiscard]] inline Big_int_sum<1> operator*(Lazy_big_int lhs, Lazy_big_int rhs)
+{
+	return Big_int_sum<1>({ Big_int_term{ &lhs.value(), &rhs.value(), false } });
+}
+
+template <std::size_t Lhs_terms, std::size_t Rhs_terms>
+[[nodiscard]] Big_int_sum<Lhs_terms + Rhs_terms>
+operator+(const Big_int_sum<Lhs_terms>& lhs, const Big_int_sum<Rhs_terms>& rhs)
+{
+	std::array<Big_int_term, Lhs_terms + Rhs_terms> terms;
+	std::copy(lhs.terms().begin(), lhs.terms().end(), terms.begin());
+	std::copy(rhs.terms().begin(), rhs.terms().end(), terms.begin() + Lhs_terms);
+	return Big_int_sum<Lhs_terms + Rhs_terms>(terms);
+}
+
+template <std::size_t Lhs_terms, std::size_t Rhs_terms>
+[[nodiscard]] Big_int_sum<Lhs_terms + Rhs_terms>
+operator-(const Big_int_sum<Lhs_terms>& lhs, const Big_int_sum<Rhs_terms>& rhs)
+{
+	return lhs + -rhs;
+}
+
+template <std::size_t Terms>
+[[nodiscard]] Big_int_sum<Terms + 1> operator+(const Big_int_sum<Terms>& lhs, const Big_int& rhs)
+{
+	return lhs + Big_int_sum<1>({ Big_int_term{ &rhs, nullptr, false } });
+}
+
+template <std::size_t Terms>
+[[nodiscard]] Big_int_sum<Terms + 1> operator+(const Big_int& lhs, const Big_int_sum<Terms>& rhs)
+{
+	return Big_int_sum<1>({ Big_int_term{ &lhs, nullptr, false } }) + rhs;
+}
+
+template <std::size_t Terms>
+[[nodiscard]] Big_int_sum<Terms + 1> operator-(const Big_int_sum<Terms>& lhs, const Big_int& rhs)
+{
+	return lhs + Big_int_sum<1>({ Big_int_term{ &rhs, nullptr, true } });
+}
+
+template <std::size_t Terms>
+[[nodiscard]] Big_int_sum<Terms + 1> operator-(const Big_int& lhs, const Big_int_sum<Terms>& rhs)
+{
+	return Big_int_sum<1>({ Big_int_term{ &lhs, nullptr, false } }) - rhs;
+}
+
+// Temporaries live until the end of the full expression, so they can be terms
+// as well. The overloads below are exact matches and so win over the rvalue
+// operators of Big_int, which need the conversion of the sum.
+
+template <std::size_t Terms>
+[[nodiscard]] Big_int_sum<Terms + 1> operator+(const Big_int_sum<Terms>& lhs, Big_int&& rhs)
+{
+	return lhs + static_cast<const Big_int&>(rhs);
+}
+
+template <std::size_t Terms>
+[[nodiscard]] Big_int_sum<Terms + 1> operator+(Big_int&& lhs, const Big_int_sum<Terms>& rhs)
+{
+	return static_cast<const Big_int&>(lhs) + rhs;
+}
+
+template <std::size_t Terms>
+[[nodiscard]] Big_int_sum<Terms + 1> operator-(const Big_int_sum<Terms>& lhs, Big_int&& rhs)
+{
+	return lhs - static_cast<const Big_int&>(rhs);
+}
+
+template <std::size_t Terms>
+[[nodiscard]] Big_int_sum<Terms + 1> operator-(Big_int&& lhs, const Big_int_sum<Terms>& rhs)
+{
+	return static_cast<const Big_int&>(lhs) - rhs;
+}
+
+#endif
@@ -0,0 +1,751 @@
+#ifndef BIG_UINT_H
+#define BIG_UINT_H
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// Wide type for the product of two limbs and the largest power of ten in a limb.
+template <typename Limb>
+struct Limb_traits;
+
+template <>
+struct Limb_traits<std::uint32_t>
+{
+	using double_limb_type = std::uint64_t;
+	static constexpr std::uint32_t decimal_base = 1'000'000'000;
+	static constexpr unsigned decimal_digits = 9;
+};
+
+#ifdef __SIZEOF_INT128__
+template <>
+struct Limb_traits<std::uint64_t>
+{
+	using double_limb_type = unsigned __int128;
+	static constexpr std::uint64_t decimal_base = 10'000'000'000'000'000'000ULL;
+	static constexpr unsigned decimal_digits = 19;
+};
+#endif
+
+/// Unsigned integer of arbitrary length in base 2^(bits of Limb).
+/// Carries are propagated with additions and shifts only, there are no
+/// divisions by the base as in Big_int. Decimal conversion is divide and conquer.
+template <typename Limb>
+class Basic_big_uint
+{
+public:
+	using limb_type = Limb;
+	using double_limb_type = typename Limb_traits<Limb>::double_limb_type;
+	using container_type = std::vector<Limb>;
+	using size_type = typename container_type::size_type;
+
+	static constexpr unsigned LIMB_BITS = std::numeric_limits<Limb>::digits;
+
+	Basic_big_uint();
+	Basic_big_uint(unsigned long long number);
+	/// Decimal digits with an optional leading '+'. Throw "Invalid number" otherwise.
+	explicit Basic_big_uint(const std::string& str);
+
+	Basic_big_uint& operator+=(const Basic_big_uint& rhs);
+	/// Throw if rhs is greater than *this.
+	Basic_big_uint& operator-=(const Basic_big_uint& rhs);
+	Basic_big_uint& operator*=(const Basic_big_uint& rhs);
+	Basic_big_uint& operator/=(const Basic_big_uint& rhs);
+	Basic_big_uint& operator%=(const Basic_big_uint& rhs);
+	Basic_big_uint& operator<<=(size_type shift);
+	Basic_big_uint& operator>>=(size_type shift);
+	Basic_big_uint& operator&=(const Basic_big_uint& rhs);
+	Basic_big_uint& operator|=(const Basic_big_uint& rhs);
+	Basic_big_uint& operator^=(const Basic_big_uint& rhs);
+
+	bool operator==(const Basic_big_uint& rhs) const = default;
+	std::strong_ordering operator<=>(const Basic_big_uint& rhs) const;
+
+	[[nodiscard]] std::string to_string() const;
+	[[nodiscard]] size_type bit_length() const;
+	/// Number of set bits.
+	[[nodiscard]] size_type popcount() const;
+	/// Little-endian limbs without leading zeros.
+	[[nodiscard]] const container_type& limbs() const;
+	void swap(Basic_big_uint& other) noexcept;
+
+	explicit operator bool() const;
+
+	/// Return { lhs / rhs, lhs % rhs } computed by one long division.
+	static std::pair<Basic_big_uint, Basic_big_uint> divmod(const Basic_big_uint& lhs, const Basic_big_uint& rhs);
+
+	/// Value of the little-endian limbs data[0, size) in base decimal_base,
+	/// each of them less than decimal_base, by divide and conquer.
+	static Basic_big_uint from_decimal_limbs(const Limb* data, size_type size);
+
+private:
+	static constexpr size_type _KARATSUBA_THRESHOLD = 32;
+	/// Size (in limbs) below which decimal conversion is quadratic.
+	static constexpr size_type _CONVERSION_THRESHOLD = 32;
+	static constexpr Limb _DECIMAL_BASE = Limb_traits<Limb>::decimal_base;
+	static constexpr unsigned _DECIMAL_DIGITS = Limb_traits<Limb>::decimal_digits;
+
+	container_type _data;
+
+	static void _delete_leading_zeros(container_type& _data);
+	static int _veccmp(const container_type& _lhs_data, const container_type& _rhs_data);
+
+	/// Similar to (_data += _rhs_data << (_shift * LIMB_BITS))
+	static void _add(container_type& _data, const container_type& _rhs_data, size_type _shift = 0);
+
+	/// Similar to (_data -= _rhs_data). Requires _data >= _rhs_data.
+	static void _subtract(container_type& _data, const container_type& _rhs_data);
+
+	/// Similar to (_data /= _divisor). Return the remainder.
+	static Limb _divide_by_word(container_type& _data, Limb _divisor);
+
+	static container_type _multiply_data(const container_type& _lhs_data, const container_type& _rhs_data);
+	static container_type _karatsuba_multiply(const container_type& _lhs_data, const container_type& _rhs_data);
+
+	/// Knuth, TAOCP vol. 2, 4.3.1, Algorithm D with normalization by a bit shift.
+	static std::pair<container_type, container_type>
+	_divmod_data(const container_type& _lhs_data, const container_type& _rhs_data);
+
+	/// _powers[k] == _DECIMAL_BASE^(2^k)
+	static void _extend_powers(std::vector<Basic_big_uint>& _powers, size_type _size);
+
+	/// Append the decimal digits of _number, padded with zeros to _width digits if _width != 0.
+	static void _write_decimal(const Basic_big_uint& _number, size_type _width,
+								std::vector<Basic_big_uint>& _powers, std::string& _out);
+
+	/// Value of _chunks[_first, _first + 2^_level) in base _DECIMAL_BASE.
+	static Basic_big_uint _read_decimal(const container_type& _chunks, size_type _first, size_type _level,
+										std::vector<Basic_big_uint>& _powers);
+};
+
+#ifdef __SIZEOF_INT128__
+using Big_uint = Basic_big_uint<std::uint64_t>;
+#else
+using Big_uint = Basic_big_uint<std::uint32_t>;
+#endif
+
+//++++++++++++++++++++Support functions+++++++++++++++++++++++++++
+template <typename Limb>
+void Basic_big_uint<Limb>::_delete_leading_zeros(container_type& _data)
+{
+	while (!_data.empty() and _data.back() == 0) {
+		_data.pop_back();
+	}
+}
+
+template <typename Limb>
+int Basic_big_uint<Limb>::_veccmp(const container_type& _lhs_data, const container_type& _rhs_data)
+{
+	if (_lhs_data.size() != _rhs_data.size()) {
+		return _lhs_data.size() > _rhs_data.size() ? 1 : -1;
+	}
+	for (size_type i = _lhs_data.size(); i != 0; --i) {
+		if (_lhs_data[i - 1] != _rhs_data[i - 1]) {
+			return _lhs_data[i - 1] > _rhs_data[i - 1] ? 1 : -1;
+		}
+	}
+	return 0;
+}
+
+template <typename Limb>
+void Basic_big_uint<Limb>::_add(container_type& _data, const container_type& _rhs_data, size_type _shift)
+{
+	if (_rhs_data.empty()) {
+		return;
+	}
+	if (_data.size() < _shift + _rhs_data.size()) {
+		_data.resize(_shift + _rhs_data.size(), 0);
+	}
+	Limb carry = 0;
+	size_type i = 0;
+	for (; i < _rhs_data.size(); ++i) {
+		Limb sum = _data[_shift + i] + _rhs_data[i];
+		Limb overflow = sum < _rhs_data[i];
+		sum += carry;
+		carry = overflow | (sum < carry);
+		_data[_shift + i] = sum;
+	}
+	for (i += _shift; carry != 0; ++i) {
+		if (i == _data.size()) {
+			_data.push_back(carry);
+			break;
+		}
+		carry = ++_data[i] == 0;
+	}
+}
+
+template <typename Limb>
+void Basic_big_uint<Limb>::_subtract(container_type& _data, const container_type& _rhs_data)
+{
+	Limb borrowed = 0;
+	for (size_type i = 0; i < _data.size() and (i < _rhs_data.size() or borrowed); ++i) {
+		Limb rhs_num = i < _rhs_data.size() ? _rhs_data[i] : 0;
+		Limb diff = _data[i] - rhs_num;
+		Limb underflow = _data[i] < rhs_num;
+		underflow |= diff < borrowed;
+		_data[i] = diff - borrowed;
+		borrowed = underflow;
+	}
+	_delete_leading_zeros(_data);
+}
+
+template <typename Limb>
+Limb Basic_big_uint<Limb>::_divide_by_word(container_type& _data, Limb _divisor)
+{
+	double_limb_type remainder = 0;
+	for (size_type i = _data.size(); i != 0; --i) {
+		double_limb_type cur = (remainder << LIMB_BITS) | _data[i - 1];
+		_data[i - 1] = static_cast<Limb>(cur / _divisor);
+		remainder = cur % _divisor;
+	}
+	_delete_leading_zeros(_data);
+	return static_cast<Limb>(remainder);
+}
+
+template <typename Limb>
+typename Basic_big_uint<Limb>::container_type
+Basic_big_uint<Limb>::_multiply_data(const container_type& _lhs_data, const container_type& _rhs_data)
+{
+	if (std::min(_lhs_data.size(), _rhs_data.size()) >= _KARATSUBA_THRESHOLD) {
+		return _karatsuba_multiply(_lhs_data, _rhs_data);
+	}
+	container_type result(_lhs_data.size() + _rhs_data.size(), 0);
+	for (size_type i = 0; i < _lhs_data.size(); ++i) {
+		double_limb_type carry = 0;
+		for (size_type j = 0; j < _rhs_data.size(); ++j) {
+			double_limb_type product =
+				static_cast<double_limb_type>(_lhs_data[i]) * _rhs_data[j] + result[i + j] + carry;
+			result[i + j] = static_cast<Limb>(product);
+			carry = product >> LIMB_BITS;
+		}
+		result[i + _rhs_data.size()] = static_cast<Limb>(carry);
+	}
+	_delete_leading_zeros(result);
+	return result;
+}
+
+template <typename Limb>
+typename Basic_big_uint<Limb>::container_type
+Basic_big_uint<Limb>::_karatsuba_multiply(const container_type& _lhs_data, const container_type& _rhs_data)
+{
+	const container_type& long_data = _lhs_data.size() < _rhs_data.size() ? _rhs_data : _lhs_data;
+	const container_type& short_data = _lhs_data.size() < _rhs_data.size() ? _lhs_data : _rhs_data;
+	auto slice = [](const container_type& data, size_type first, size_type last) {
+		first = std::min(first, data.size());
+		last = std::min(last, data.size());
+		container_type ret(data.begin() + first, data.begin() + last);
+		_delete_leading_zeros(ret);
+		return ret;
+	};
+
+	container_type result;
+	if (long_data.size() >= 2 * short_data.size()) {
+		for (size_type i = 0; i < long_data.size(); i += short_data.size()) {
+			_add(result, _multiply_data(slice(long_data, i, i + short_data.size()), short_data), i);
+		}
+		return result;
+	}
+
+	size_type k = (long_data.size() + 1) / 2;
+	container_type a0 = slice(long_data, 0, k);
+	container_type a1 = slice(long_data, k, long_data.size());
+	container_type b0 = slice(short_data, 0, k);
+	container_type b1 = slice(short_data, k, short_data.size());
+
+	container_type z0 = _multiply_data(a0, b0);
+	container_type z2 = _multiply_data(a1, b1);
+	_add(a0, a1);
+	_add(b0, b1);
+	container_type z1 = _multiply_data(a0, b0);
+	_subtract(z1, z0);
+	_subtract(z1, z2);
+
+	result = std::move(z0);
+	_add(result, z1, k);
+	_add(result, z2, 2 * k);
+	_delete_leading_zeros(result);
+	return result;
+}
+
+template <typename Limb>
+std::pair<typename Basic_big_uint<Limb>::container_type, typename Basic_big_uint<Limb>::container_type>
+Basic_big_uint<Limb>::_divmod_data(const container_type& _lhs_data, const container_type& _rhs_data)
+{
+	if (_veccmp(_lhs_data, _rhs_data) == -1) {
+		return { container_type(), _lhs_data };
+	}
+	if (_rhs_data.size() == 1) {
+		container_type quotient = _lhs_data;
+		Limb remainder = _divide_by_word(quotient, _rhs_data.front());
+		return { quotient, remainder == 0 ? container_type() : container_type(1, remainder) };
+	}
+
+	// Shift so that the top bit of the divisor is set.
+	unsigned shift = std::countl_zero(_rhs_data.back());
+	Basic_big_uint u;
+	Basic_big_uint v;
+	u._data = _lhs_data;
+	v._data = _rhs_data;
+	u <<= shift;
+	v <<= shift;
+	size_type n = v._data.size();
+	size_type m = _lhs_data.size() - n;
+	u._data.resize(_lhs_data.size() + 1, 0);
+
+	const double_limb_type v_top = v._data[n - 1];
+	const double_limb_type v_next = v._data[n - 2];
+	container_type quotient(m + 1, 0);
+	for (size_type j = m + 1; j != 0; --j) {
+		size_type reverse_j = j - 1;
+		double_limb_type numerator = (static_cast<double_limb_type>(u._data[reverse_j + n]) << LIMB_BITS) | u._data[reverse_j + n - 1];
+		double_limb_type q_hat = numerator / v_top;
+		double_limb_type r_hat = numerator % v_top;
+		while ((q_hat >> LIMB_BITS) != 0 or q_hat * v_next > ((r_hat << LIMB_BITS) | u._data[reverse_j + n - 2])) {
+			--q_hat;
+			r_hat += v_top;
+			if ((r_hat >> LIMB_BITS) != 0) {
+				break;
+			}
+		}
+
+		double_limb_type carry = 0;
+		Limb borrowed = 0;
+		for (size_type i = 0; i < n; ++i) {
+			double_limb_type product = q_hat * v._data[i] + carry;
+			carry = product >> LIMB_BITS;
+			Limb product_low = static_cast<Limb>(product);
+			Limb limb = u._data[reverse_j + i];
+			Limb diff = limb - product_low;
+			Limb underflow = limb < product_low;
+			underflow |= diff < borrowed;
+			u._data[reverse_j + i] = diff - borrowed;
+			borrowed = underflow;
+		}
+		Limb top = u._data[reverse_j + n];
+		bool is_negative = static_cast<double_limb_type>(top) < carry + borrowed;
+		u._data[reverse_j + n] = top - static_cast<Limb>(carry) - borrowed;
+
+		if (is_negative) {
+			--q_hat;
+			Limb add_carry = 0;
+			for (size_type i = 0; i < n; ++i) {
+				Limb sum = u._data[reverse_j + i] + v._data[i];
+				Limb overflow = sum < v._data[i];
+				sum += add_carry;
+				add_carry = overflow | (sum < add_carry);
+				u._data[reverse_j + i] = sum;
+			}
+			u._data[reverse_j + n] += add_carry;
+		}
+		quotient[reverse_j] = static_cast<Limb>(q_hat);
+	}
+	_delete_leading_zeros(quotient);
+
+	u._data.resize(n);
+	_delete_leading_zeros(u._data);
+	u >>= shift;
+	return { quotient, u._data };
+}
+
+template <typename Limb>
+void Basic_big_uint<Limb>::_extend_powers(std::vector<Basic_big_uint>& _powers, size_type _size)
+{
+	if (_powers.empty()) {
+		_powers.emplace_back(_DECIMAL_BASE);
+	}
+	while (_powers.back()._data.size() * 2 <= _size + 1) {
+		_powers.push_back(_powers.back() * _powers.back());
+	}
+}
+
+template <typename Limb>
+void Basic_big_uint<Limb>::_write_decimal(const Basic_big_uint& _number, size_type _width,
+											std::vector<Basic_big_uint>& _powers, std::string& _out)
+{
+	if (_number._data.size() < _CONVERSION_THRESHOLD) {
+		container_type data = _number._data;
+		std::string digits;
+		while (!data.empty()) {
+			std::string chunk = std::to_string(_divide_by_word(data, _DECIMAL_BASE));
+			if (!data.empty()) {
+				chunk.insert(0, _DECIMAL_DIGITS - chunk.size(), '0');
+			}
+			digits.insert(0, chunk);
+		}
+		if (digits.size() < _width) {
+			_out.append(_width - digits.size(), '0');
+		}
+		_out += digits;
+		return;
+	}
+
+	// _number = high * _powers[level] + low, low has exactly (_DECIMAL_DIGITS << level) digits.
+	size_type level = 0;
+	while (level + 1 < _powers.size() and _powers[level + 1]._data.size() * 2 <= _number._data.size() + 1) {
+		++level;
+	}
+	auto [high, low] = divmod(_number, _powers[level]);
+	size_type low_width = static_cast<size_type>(_DECIMAL_DIGITS) << level;
+	_write_decimal(high, _width > low_width ? _width - low_width : 0, _powers, _out);
+	_write_decimal(low, low_width, _powers, _out);
+}
+
+template <typename Limb>
+Basic_big_uint<Limb> Basic_big_uint<Limb>::_read_decimal(const container_type& _chunks, size_type _first,
+															size_type _level, std::vector<Basic_big_uint>& _powers)
+{
+	if (_first >= _chunks.size()) {
+		return Basic_big_uint();
+	}
+	if (_level == 0) {
+		return Basic_big_uint(_chunks[_first]);
+	}
+	size_type half = size_type(1) << (_level - 1);
+	Basic_big_uint ret = _read_decimal(_chunks, _first + half, _level - 1, _powers);
+	if (ret) {
+		ret *= _powers[_level - 1];
+	}
+	ret += _read_decimal(_chunks, _first, _level - 1, _powers);
+	return ret;
+}
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+template <typename Limb>
+Basic_big_uint<Limb>::Basic_big_uint()
+	: _data() {}
+
+template <typename Limb>
+Basic_big_uint<Limb>::Basic_big_uint(unsigned long long number)
+{
+	while (number != 0) {
+		_data.push_back(static_cast<Limb>(number));
+		if constexpr (LIMB_BITS < std::numeric_limits<unsigned long long>::digits) {
+			number >>= LIMB_BITS;
+		}
+		else {
+			number = 0;
+		}
+	}
+}
+
+template <typename Limb>
+Basic_big_uint<Limb>::Basic_big_uint(const std::string& str)
+{
+	using str_size = std::string::size_type;
+	str_size shift = !str.empty() and str.front() == '+';
+	if (shift == str.size() or
+		!std::all_of(str.begin() + shift, str.end(), [](char c) { return c >= '0' and c <= '9'; })) {
+		throw "Invalid number";
+	}
+	while (shift < str.size() and str[shift] == '0') {
+		++shift;
+	}
+
+	// Chunks of _DECIMAL_DIGITS digits from the least significant end.
+	container_type chunks;
+	for (str_size end = str.size(); end > shift; ) {
+		str_size begin = end - std::min<str_size>(_DECIMAL_DIGITS, end - shift);
+		Limb chunk = 0;
+		for (str_size i = begin; i < end; ++i) {
+			chunk = chunk * 10 + static_cast<Limb>(str[i] - '0');
+		}
+		chunks.push_back(chunk);
+		end = begin;
+	}
+	*this = from_decimal_limbs(chunks.data(), chunks.size());
+}
+
+template <typename Limb>
+Basic_big_uint<Limb>& Basic_big_uint<Limb>::operator+=(const Basic_big_uint& rhs)
+{
+	_add(_data, rhs._data);
+	return *this;
+}
+
+template <typename Limb>
+Basic_big_uint<Limb>& Basic_big_uint<Limb>::operator-=(const Basic_big_uint& rhs)
+{
+	if (_veccmp(_data, rhs._data) == -1) {
+		throw "Negative result of unsigned subtraction";
+	}
+	_subtract(_data, rhs._data);
+	return *this;
+}
+
+template <typename Limb>
+Basic_big_uint<Limb>& Basic_big_uint<Limb>::operator*=(const Basic_big_uint& rhs)
+{
+	_data = _multiply_data(_data, rhs._data);
+	return *this;
+}
+
+template <typename Limb>
+Basic_big_uint<Limb>& Basic_big_uint<Limb>::operator/=(const Basic_big_uint& rhs)
+{
+	if (!rhs) {
+		throw "Division by zero";
+	}
+	_data = _divmod_data(_data, rhs._data).first;
+	return *this;
+}
+
+template <typename Limb>
+Basic_big_uint<Limb>& Basic_big_uint<Limb>::operator%=(const Basic_big_uint& rhs)
+{
+	if (!rhs) {
+		throw "Division by zero";
+	}
+	_data = _divmod_data(_data, rhs._data).second;
+	return *this;
+}
+
+template <typename Limb>
+Basic_big_uint<Limb>& Basic_big_uint<Limb>::operator<<=(size_type shift)
+{
+	if (_data.empty()) {
+		return *this;
+	}
+	size_type limbs = shift / LIMB_BITS;
+	unsigned bits = shift % LIMB_BITS;
+	if (bits != 0) {
+		Limb carry = 0;
+		for (auto& limb : _data) {
+			Limb next_carry = limb >> (LIMB_BITS - bits);
+			limb = (limb << bits) | carry;
+			carry = next_carry;
+		}
+		if (carry != 0) {
+			_data.push_back(carry);
+		}
+	}
+	_data.insert(_data.begin(), limbs, 0);
+	return *this;
+}
+
+template <typename Limb>
+Basic_big_uint<Limb>& Basic_big_uint<Limb>::operator>>=(size_type shift)
+{
+	size_type limbs = shift / LIMB_BITS;
+	unsigned bits = shift % LIMB_BITS;
+	_data.erase(_data.begin(), _data.begin() + std::min(limbs, _data.size()));
+	if (bits != 0 and !_data.empty()) {
+		for (size_type i = 0; i + 1 < _data.size(); ++i) {
+			_data[i] = (_data[i] >> bits) | (_data[i + 1] << (LIMB_BITS - bits));
+		}
+		_data.back() >>= bits;
+		_delete_leading_zeros(_data);
+	}
+	return *this;
+}
+
+template <typename Limb>
+Basic_big_uint<Limb>& Basic_big_uint<Limb>::operator&=(const Basic_big_uint& rhs)
+{
+	_data.resize(std::min(_data.size(), rhs._data.size()));
+	for (size_type i = 0; i < _data.size(); ++i) {
+		_data[i] &= rhs._data[i];
+	}
+	_delete_leading_zeros(_data);
+	return *this;
+}
+
+template <typename Limb>
+Basic_big_uint<Limb>& Basic_big_uint<Limb>::operator|=(const Basic_big_uint& rhs)
+{
+	if (_data.size() < rhs._data.size()) {
+		_data.resize(rhs._data.size(), 0);
+	}
+	for (size_type i = 0; i < rhs._data.size(); ++i) {
+		_data[i] |= rhs._data[i];
+	}
+	return *this;
+}
+
+template <typename Limb>
+Basic_big_uint<Limb>& Basic_big_uint<Limb>::operator^=(const Basic_big_uint& rhs)
+{
+	if (_data.size() < rhs._data.size()) {
+		_data.resize(rhs._data.size(), 0);
+	}
+	for (size_type i = 0; i < rhs._data.size(); ++i) {
+		_data[i] ^= rhs._data[i];
+	}
+	_delete_leading_zeros(_data);
+	return *this;
+}
+
+template <typename Limb>
+std::strong_ordering Basic_big_uint<Limb>::operator<=>(const Basic_big_uint& rhs) const
+{
+	return _veccmp(_data, rhs._data) <=> 0;
+}
+
+template <typename Limb>
+std::string Basic_big_uint<Limb>::to_string() const
+{
+	if (_data.empty()) {
+		return "0";
+	}
+	std::vector<Basic_big_uint> powers;
+	_extend_powers(powers, _data.size());
+	std::string ret;
+	_write_decimal(*this, 0, powers, ret);
+	return ret;
+}
+
+template <typename Limb>
+typename Basic_big_uint<Limb>::size_type Basic_big_uint<Limb>::bit_length() const
+{
+	return _data.empty() ? 0 : _data.size() * LIMB_BITS - std::countl_zero(_data.back());
+}
+
+template <typename Limb>
+typename Basic_big_uint<Limb>::size_type Basic_big_uint<Limb>::popcount() const
+{
+	size_type ret = 0;
+	for (Limb limb : _data) {
+		ret += std::popcount(limb);
+	}
+	return ret;
+}
+
+template <typename Limb>
+const typename Basic_big_uint<Limb>::container_type& Basic_big_uint<Limb>::limbs() const
+{
+	return _data;
+}
+
+template <typename Limb>
+void Basic_big_uint<Limb>::swap(Basic_big_uint& other) noexcept
+{
+	_data.swap(other._data);
+}
+
+template <typename Limb>
+Basic_big_uint<Limb>::operator bool() const
+{
+	return !_data.empty();
+}
+
+template <typename Limb>
+std::pair<Basic_big_uint<Limb>, Basic_big_uint<Limb>>
+Basic_big_uint<Limb>::divmod(const Basic_big_uint& lhs, const Basic_big_uint& rhs)
+{
+	if (!rhs) {
+		throw "Division by zero";
+	}
+	auto [quotient_data, remainder_data] = _divmod_data(lhs._data, rhs._data);
+	std::pair<Basic_big_uint, Basic_big_uint> ret;
+	ret.first._data = std::move(quotient_data);
+	ret.second._data = std::move(remainder_data);
+	return ret;
+}
+
+template <typename Limb>
+Basic_big_uint<Limb> Basic_big_uint<Limb>::from_decimal_limbs(const Limb* data, size_type size)
+{
+	container_type chunks(data, data + size);
+	size_type level = 0;
+	while ((size_type(1) << level) < chunks.size()) {
+		++level;
+	}
+	std::vector<Basic_big_uint> powers(1, Basic_big_uint(_DECIMAL_BASE));
+	while (powers.size() < level) {
+		powers.push_back(powers.back() * powers.back());
+	}
+	return _read_decimal(chunks, 0, level, powers);
+}
+
+template <typename Limb>
+std::ostream& operator<<(std::ostream& os, const Basic_big_uint<Limb>& number)
+{
+	return os << number.to_string();
+}
+
+template <typename Limb>
+Basic_big_uint<Limb> operator+(const Basic_big_uint<Limb>& lhs, const Basic_big_uint<Limb>& rhs)
+{
+	Basic_big_uint<Limb> ret(lhs);
+	ret += rhs;
+	return ret;
+}
+
+template <typename Limb>
+Basic_big_uint<Limb> operator-(const Basic_big_uint<Limb>& lhs, const Basic_big_uint<Limb>& rhs)
+{
+	Basic_big_uint<Limb> ret(lhs);
+	ret -= rhs;
+	return ret;
+}
+
+template <typename Limb>
+Basic_big_uint<Limb> operator*(const Basic_big_uint<Limb>& lhs, const Basic_big_uint<Limb>& rhs)
+{
+	Basic_big_uint<Limb> ret(lhs);
+	ret *= rhs;
+	return ret;
+}
+
+template <typename Limb>
+Basic_big_uint<Limb> operator/(const Basic_big_uint<Limb>& lhs, const Basic_big_uint<Limb>& rhs)
+{
+	Basic_big_uint<Limb> ret(lhs);
+	ret /= rhs;
+	return ret;
+}
+
+template <typename Limb>
+Basic_big_uint<Limb> operator%(const Basic_big_uint<Limb>& lhs, const Basic_big_uint<Limb>& rhs)
+{
+	Basic_big_uint<Limb> ret(lhs);
+	ret %= rhs;
+	return ret;
+}
+
+template <typename Limb>
+Basic_big_uint<Limb> operator<<(const Basic_big_uint<Limb>& lhs, std::size_t shift)
+{
+	Basic_big_uint<Limb> ret(lhs);
+	ret <<= shift;
+	return ret;
+}
+
+template <typename Limb>
+Basic_big_uint<Limb> operator>>(const Basic_big_uint<Limb>& lhs, std::size_t shift)
+{
+	Basic_big_uint<Limb> ret(lhs);
+	ret >>= shift;
+	return ret;
+}
+
+template <typename Limb>
+Basic_big_uint<Limb> operator&(const Basic_big_uint<Limb>& lhs, const Basic_big_uint<Limb>& rhs)
+{
+	Basic_big_uint<Limb> ret(lhs);
+	ret &= rhs;
+	return ret;
+}
+
+template <typename Limb>
+Basic_big_uint<Limb> operator|(const Basic_big_uint<Limb>& lhs, const Basic_big_uint<Limb>& rhs)
+{
+	Basic_big_uint<Limb> ret(lhs);
+	ret |= rhs;
+	return ret;
+}
+
+template <typename Limb>
+Basic_big_uint<Limb> operator^(const Basic_big_uint<Limb>& lhs, const Basic_big_uint<Limb>& rhs)
+{
+	Basic_big_uint<Limb> ret(lhs);
+	ret ^= rhs;
+	return ret;
+}
+
+#endif
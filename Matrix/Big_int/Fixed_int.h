@@ -0,0 +1,574 @@
+#ifndef FIXED_INT_H
+#define FIXED_INT_H
+
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include "Big_int.h"
+#include "Big_uint.h"
+
+/// Signed integer with an absolute value below 2^Bits, stored in place
+/// as a sign and Bits / LIMB_BITS binary limbs, without heap allocation.
+/// All loops have bounds known at compile time, and the arithmetic is
+/// constexpr. Operations whose result does not fit throw "Fixed_int overflow";
+/// try_add, try_subtract and try_multiply report the overflow instead, so that
+/// the caller can redo the operation on to_big_int().
+/// Division and remainder round toward zero like Big_int.
+template <std::size_t Bits>
+class Fixed_int
+{
+public:
+	using limb_type = Big_uint::limb_type;
+	using double_limb_type = Big_uint::double_limb_type;
+
+	static constexpr unsigned LIMB_BITS = Big_uint::LIMB_BITS;
+	static constexpr std::size_t LIMBS = Bits / LIMB_BITS;
+	static_assert(Bits != 0 and Bits % 64 == 0, "Bits must be a positive multiple of 64");
+
+	constexpr Fixed_int();
+	constexpr Fixed_int(long long number);
+	/// Throw if |number| >= 2^Bits.
+	explicit Fixed_int(const Big_int& number);
+	explicit Fixed_int(const std::string& str);
+
+	constexpr Fixed_int& operator+=(const Fixed_int& rhs);
+	constexpr Fixed_int& operator-=(const Fixed_int& rhs);
+	constexpr Fixed_int& operator*=(const Fixed_int& rhs);
+	/// Throw if rhs is zero.
+	constexpr Fixed_int& operator/=(const Fixed_int& rhs);
+	constexpr Fixed_int& operator%=(const Fixed_int& rhs);
+
+	/// Similar to (*this += rhs), (*this -= rhs) and (*this *= rhs).
+	/// Return false and leave *this unchanged if the result does not fit.
+	[[nodiscard]] constexpr bool try_add(const Fixed_int& rhs);
+	[[nodiscard]] constexpr bool try_subtract(const Fixed_int& rhs);
+	[[nodiscard]] constexpr bool try_multiply(const Fixed_int& rhs);
+
+	[[nodiscard]] constexpr Fixed_int operator+() const;
+	[[nodiscard]] constexpr Fixed_int operator-() const;
+
+	constexpr Fixed_int& operator++();
+	constexpr Fixed_int operator++(int);
+	constexpr Fixed_int& operator--();
+	constexpr Fixed_int operator--(int);
+
+	constexpr bool operator==(const Fixed_int& rhs) const = default;
+	constexpr std::strong_ordering operator<=>(const Fixed_int& rhs) const;
+
+	[[nodiscard]] std::string to_string() const;
+	[[nodiscard]] Big_int to_big_int() const;
+	constexpr Fixed_int& negate();
+
+	constexpr explicit operator bool() const;
+
+	/// Largest value, 2^Bits - 1. The smallest one is -max().
+	[[nodiscard]] static constexpr Fixed_int max();
+
+	// Defined here so that an integer operand converts like for Big_int: x + 1.
+	friend constexpr Fixed_int operator+(Fixed_int lhs, const Fixed_int& rhs)
+	{
+		lhs += rhs;
+		return lhs;
+	}
+
+	friend constexpr Fixed_int operator-(Fixed_int lhs, const Fixed_int& rhs)
+	{
+		lhs -= rhs;
+		return lhs;
+	}
+
+	friend constexpr Fixed_int operator*(Fixed_int lhs, const Fixed_int& rhs)
+	{
+		lhs *= rhs;
+		return lhs;
+	}
+
+	friend constexpr Fixed_int operator/(Fixed_int lhs, const Fixed_int& rhs)
+	{
+		lhs /= rhs;
+		return lhs;
+	}
+
+	friend constexpr Fixed_int operator%(Fixed_int lhs, const Fixed_int& rhs)
+	{
+		lhs %= rhs;
+		return lhs;
+	}
+
+private:
+	using magnitude_type = std::array<limb_type, LIMBS>;
+
+	bool _sign;
+	magnitude_type _data;	// little-endian absolute value
+
+	/// Similar to strcmp from C.
+	static constexpr int _compare(const magnitude_type& _lhs, const magnitude_type& _rhs);
+
+	/// Similar to (_data += _rhs). Return the carry out of the last limb.
+	static constexpr bool _add(magnitude_type& _data, const magnitude_type& _rhs);
+
+	/// Similar to (_data -= _rhs). Requires _data >= _rhs.
+	static constexpr void _subtract(magnitude_type& _data, const magnitude_type& _rhs);
+
+	/// Similar to (_data /= _divisor). Return the remainder.
+	static constexpr limb_type _divide_by_word(magnitude_type& _data, limb_type _divisor);
+
+	/// Number of limbs without leading zeros.
+	static constexpr std::size_t _size(const magnitude_type& _data);
+
+	/// Knuth, TAOCP vol. 2, 4.3.1, Algorithm D, as in Basic_big_uint. Requires _rhs != 0.
+	static constexpr void _divmod(const magnitude_type& _lhs, const magnitude_type& _rhs,
+									magnitude_type& _quotient, magnitude_type& _remainder);
+
+	/// Similar to (*this += _rhs) or (*this -= _rhs) if _negate.
+	constexpr bool _try_add(const Fixed_int& _rhs, bool _negate);
+
+	/// Zero is not negative.
+	constexpr void _correct_sign();
+};
+
+//++++++++++++++++++++Support functions+++++++++++++++++++++++++++
+template <std::size_t Bits>
+constexpr int Fixed_int<Bits>::_compare(const magnitude_type& _lhs, const magnitude_type& _rhs)
+{
+	for (std::size_t i = LIMBS; i != 0; --i) {
+		if (_lhs[i - 1] != _rhs[i - 1]) {
+			return _lhs[i - 1] > _rhs[i - 1] ? 1 : -1;
+		}
+	}
+	return 0;
+}
+
+template <std::size_t Bits>
+constexpr bool Fixed_int<Bits>::_add(magnitude_type& _data, const magnitude_type& _rhs)
+{
+	limb_type carry = 0;
+	for (std::size_t i = 0; i < LIMBS; ++i) {
+		limb_type sum = _data[i] + _rhs[i];
+		limb_type overflow = sum < _rhs[i];
+		sum += carry;
+		carry = overflow | (sum < carry);
+		_data[i] = sum;
+	}
+	return carry != 0;
+}
+
+template <std::size_t Bits>
+constexpr void Fixed_int<Bits>::_subtract(magnitude_type& _data, const magnitude_type& _rhs)
+{
+	limb_type borrowed = 0;
+	for (std::size_t i = 0; i < LIMBS; ++i) {
+		limb_type diff = _data[i] - _rhs[i];
+		limb_type underflow = _data[i] < _rhs[i];
+		underflow |= diff < borrowed;
+		_data[i] = diff - borrowed;
+		borrowed = underflow;
+	}
+}
+
+template <std::size_t Bits>
+constexpr typename Fixed_int<Bits>::limb_type Fixed_int<Bits>::_divide_by_word(magnitude_type& _data, limb_type _divisor)
+{
+	double_limb_type remainder = 0;
+	for (std::size_t i = LIMBS; i != 0; --i) {
+		double_limb_type cur = (remainder << LIMB_BITS) | _data[i - 1];
+		_data[i - 1] = static_cast<limb_type>(cur / _divisor);
+		remainder = cur % _divisor;
+	}
+	return static_cast<limb_type>(remainder);
+}
+
+template <std::size_t Bits>
+constexpr std::size_t Fixed_int<Bits>::_size(const magnitude_type& _data)
+{
+	std::size_t ret = LIMBS;
+	while (ret != 0 and _data[ret - 1] == 0) {
+		--ret;
+	}
+	return ret;
+}
+
+template <std::size_t Bits>
+constexpr void Fixed_int<Bits>::_divmod(const magnitude_type& _lhs, const magnitude_type& _rhs,
+										magnitude_type& _quotient, magnitude_type& _remainder)
+{
+	_quotient = {};
+	_remainder = {};
+	if (_compare(_lhs, _rhs) == -1) {
+		_remainder = _lhs;
+		return;
+	}
+	std::size_t n = _size(_rhs);
+	if (n == 1) {
+		_quotient = _lhs;
+		_remainder[0] = _divide_by_word(_quotient, _rhs[0]);
+		return;
+	}
+
+	// Shift so that the top bit of the divisor is set.
+	unsigned shift = std::countl_zero(_rhs[n - 1]);
+	std::array<limb_type, LIMBS + 1> u = {};
+	magnitude_type v = {};
+	for (std::size_t i = 0; i < LIMBS; ++i) {
+		u[i] |= _lhs[i] << shift;
+		v[i] |= _rhs[i] << shift;
+		if (shift != 0) {
+			u[i + 1] = _lhs[i] >> (LIMB_BITS - shift);
+			if (i + 1 < LIMBS) {
+				v[i + 1] = _rhs[i] >> (LIMB_BITS - shift);
+			}
+		}
+	}
+	std::size_t m = _size(_lhs) - n;
+
+	const double_limb_type v_top = v[n - 1];
+	const double_limb_type v_next = v[n - 2];
+	for (std::size_t j = m + 1; j != 0; --j) {
+		std::size_t k = j - 1;
+		double_limb_type numerator = (static_cast<double_limb_type>(u[k + n]) << LIMB_BITS) | u[k + n - 1];
+		double_limb_type q_hat = numerator / v_top;
+		double_limb_type r_hat = numerator % v_top;
+		while ((q_hat >> LIMB_BITS) != 0 or q_hat * v_next > ((r_hat << LIMB_BITS) | u[k + n - 2])) {
+			--q_hat;
+			r_hat += v_top;
+			if ((r_hat >> LIMB_BITS) != 0) {
+				break;
+			}
+		}
+
+		double_limb_type carry = 0;
+		limb_type borrowed = 0;
+		for (std::size_t i = 0; i < n; ++i) {
+			double_limb_type product = q_hat * v[i] + carry;
+			carry = product >> LIMB_BITS;
+			limb_type product_low = static_cast<limb_type>(product);
+			limb_type diff = u[k + i] - product_low;
+			limb_type underflow = u[k + i] < product_low;
+			underflow |= diff < borrowed;
+			u[k + i] = diff - borrowed;
+			borrowed = underflow;
+		}
+		limb_type top = u[k + n];
+		bool is_negative = static_cast<double_limb_type>(top) < carry + borrowed;
+		u[k + n] = top - static_cast<limb_type>(carry) - borrowed;
+
+		if (is_negative) {
+			--q_hat;
+			limb_type add_carry = 0;
+			for (std::size_t i = 0; i < n; ++i) {
+				limb_type sum = u[k + i] + v[i];
+				limb_type overflow = sum < v[i];
+				sum += add_carry;
+				add_carry = overflow | (sum < add_carry);
+				u[k + i] = sum;
+			}
+			u[k + n] += add_carry;
+		}
+		_quotient[k] = static_cast<limb_type>(q_hat);
+	}
+
+	for (std::size_t i = 0; i < n; ++i) {
+		_remainder[i] = u[i] >> shift;
+		if (shift != 0 and i + 1 < n) {
+			_remainder[i] |= u[i + 1] << (LIMB_BITS - shift);
+		}
+	}
+}
+
+template <std::size_t Bits>
+constexpr bool Fixed_int<Bits>::_try_add(const Fixed_int& _rhs, bool _negate)
+{
+	bool rhs_sign = _rhs._sign != _negate;
+	if (_sign == rhs_sign) {
+		magnitude_type sum = _data;
+		if (_add(sum, _rhs._data)) {
+			return false;
+		}
+		_data = sum;
+	}
+	else if (_compare(_data, _rhs._data) != -1) {
+		_subtract(_data, _rhs._data);
+	}
+	else {
+		magnitude_type difference = _rhs._data;
+		_subtract(difference, _data);
+		_data = difference;
+		_sign = rhs_sign;
+	}
+	_correct_sign();
+	return true;
+}
+
+template <std::size_t Bits>
+constexpr void Fixed_int<Bits>::_correct_sign()
+{
+	if (_size(_data) == 0) {
+		_sign = false;
+	}
+}
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+template <std::size_t Bits>
+constexpr Fixed_int<Bits>::Fixed_int()
+	: _sign(false)
+	, _data() {}
+
+template <std::size_t Bits>
+constexpr Fixed_int<Bits>::Fixed_int(long long number)
+	: _sign(number < 0)
+	, _data()
+{
+	unsigned long long magnitude = number < 0 ? 0ULL - static_cast<unsigned long long>(number) : number;
+	for (std::size_t i = 0; i < 64 / LIMB_BITS; ++i) {
+		_data[i] = static_cast<limb_type>(magnitude >> (i * LIMB_BITS));
+	}
+}
+
+template <std::size_t Bits>
+Fixed_int<Bits>::Fixed_int(const Big_int& number)
+	: _sign(number < 0)
+	, _data()
+{
+	Big_int::binary_type binary = number.to_binary();
+	if (binary.bit_length() > Bits) {
+		throw "Fixed_int overflow";
+	}
+	constexpr unsigned BINARY_BITS = Big_int::binary_type::LIMB_BITS;
+	const auto& limbs = binary.limbs();
+	for (std::size_t i = 0; i < limbs.size(); ++i) {
+		_data[i * BINARY_BITS / LIMB_BITS] |= static_cast<limb_type>(limbs[i]) << (i * BINARY_BITS % LIMB_BITS);
+	}
+}
+
+template <std::size_t Bits>
+Fixed_int<Bits>::Fixed_int(const std::string& str)
+	: Fixed_int(Big_int(str)) {}
+
+template <std::size_t Bits>
+constexpr Fixed_int<Bits>& Fixed_int<Bits>::operator+=(const Fixed_int& rhs)
+{
+	if (!try_add(rhs)) {
+		throw "Fixed_int overflow";
+	}
+	return *this;
+}
+
+template <std::size_t Bits>
+constexpr Fixed_int<Bits>& Fixed_int<Bits>::operator-=(const Fixed_int& rhs)
+{
+	if (!try_subtract(rhs)) {
+		throw "Fixed_int overflow";
+	}
+	return *this;
+}
+
+template <std::size_t Bits>
+constexpr Fixed_int<Bits>& Fixed_int<Bits>::operator*=(const Fixed_int& rhs)
+{
+	if (!try_multiply(rhs)) {
+		throw "Fixed_int overflow";
+	}
+	return *this;
+}
+
+template <std::size_t Bits>
+constexpr Fixed_int<Bits>& Fixed_int<Bits>::operator/=(const Fixed_int& rhs)
+{
+	if (!rhs) {
+		throw "Division by zero";
+	}
+	// Copies of the operands, rhs can be *this.
+	magnitude_type lhs_data = _data;
+	magnitude_type rhs_data = rhs._data;
+	magnitude_type remainder = {};
+	_sign = _sign != rhs._sign;
+	_divmod(lhs_data, rhs_data, _data, remainder);
+	_correct_sign();
+	return *this;
+}
+
+template <std::size_t Bits>
+constexpr Fixed_int<Bits>& Fixed_int<Bits>::operator%=(const Fixed_int& rhs)
+{
+	if (!rhs) {
+		throw "Division by zero";
+	}
+	magnitude_type lhs_data = _data;
+	magnitude_type rhs_data = rhs._data;
+	magnitude_type quotient = {};
+	_divmod(lhs_data, rhs_data, quotient, _data);
+	_correct_sign();
+	return *this;
+}
+
+template <std::size_t Bits>
+constexpr bool Fixed_int<Bits>::try_add(const Fixed_int& rhs)
+{
+	return _try_add(rhs, false);
+}
+
+template <std::size_t Bits>
+constexpr bool Fixed_int<Bits>::try_subtract(const Fixed_int& rhs)
+{
+	return _try_add(rhs, true);
+}
+
+template <std::size_t Bits>
+constexpr bool Fixed_int<Bits>::try_multiply(const Fixed_int& rhs)
+{
+	// Only the partial products below 2^Bits are computed,
+	// any nonzero one above them is an overflow.
+	magnitude_type result = {};
+	for (std::size_t i = 0; i < LIMBS; ++i) {
+		if (_data[i] == 0) {
+			continue;
+		}
+		double_limb_type carry = 0;
+		for (std::size_t j = 0; i + j < LIMBS; ++j) {
+			double_limb_type product = static_cast<double_limb_type>(_data[i]) * rhs._data[j] + result[i + j] + carry;
+			result[i + j] = static_cast<limb_type>(product);
+			carry = product >> LIMB_BITS;
+		}
+		if (carry != 0) {
+			return false;
+		}
+		for (std::size_t j = LIMBS - i; j < LIMBS; ++j) {
+			if (rhs._data[j] != 0) {
+				return false;
+			}
+		}
+	}
+	_data = result;
+	_sign = _sign != rhs._sign;
+	_correct_sign();
+	return true;
+}
+
+template <std::size_t Bits>
+constexpr Fixed_int<Bits> Fixed_int<Bits>::operator+() const
+{
+	return *this;
+}
+
+template <std::size_t Bits>
+constexpr Fixed_int<Bits> Fixed_int<Bits>::operator-() const
+{
+	Fixed_int ret(*this);
+	ret.negate();
+	return ret;
+}
+
+template <std::size_t Bits>
+constexpr Fixed_int<Bits>& Fixed_int<Bits>::operator++()
+{
+	return *this += 1;
+}
+
+template <std::size_t Bits>
+constexpr Fixed_int<Bits> Fixed_int<Bits>::operator++(int)
+{
+	Fixed_int ret(*this);
+	*this += 1;
+	return ret;
+}
+
+template <std::size_t Bits>
+constexpr Fixed_int<Bits>& Fixed_int<Bits>::operator--()
+{
+	return *this -= 1;
+}
+
+template <std::size_t Bits>
+constexpr Fixed_int<Bits> Fixed_int<Bits>::operator--(int)
+{
+	Fixed_int ret(*this);
+	*this -= 1;
+	return ret;
+}
+
+template <std::size_t Bits>
+constexpr std::strong_ordering Fixed_int<Bits>::operator<=>(const Fixed_int& rhs) const
+{
+	if (_sign != rhs._sign) {
+		return _sign ? std::strong_ordering::less : std::strong_ordering::greater;
+	}
+	int compare = _compare(_data, rhs._data);
+	return (_sign ? -compare : compare) <=> 0;
+}
+
+template <std::size_t Bits>
+std::string Fixed_int<Bits>::to_string() const
+{
+	constexpr limb_type DECIMAL_BASE = Limb_traits<limb_type>::decimal_base;
+	constexpr unsigned DECIMAL_DIGITS = Limb_traits<limb_type>::decimal_digits;
+	magnitude_type data = _data;
+	std::string ret;
+	do {
+		std::string chunk = std::to_string(_divide_by_word(data, DECIMAL_BASE));
+		if (_size(data) != 0) {
+			chunk.insert(0, DECIMAL_DIGITS - chunk.size(), '0');
+		}
+		ret.insert(0, chunk);
+	} while (_size(data) != 0);
+	if (_sign) {
+		ret.insert(0, 1, '-');
+	}
+	return ret;
+}
+
+template <std::size_t Bits>
+Big_int Fixed_int<Bits>::to_big_int() const
+{
+	// Limbs of Big_int are the chunks of 9 decimal digits.
+	constexpr limb_type BIG_INT_BASE = 1'000'000'000;
+	magnitude_type data = _data;
+	std::array<Big_int::word_type, Bits / 29 + 1> chunks = {};
+	std::size_t size = 0;
+	while (_size(data) != 0) {
+		chunks[size++] = static_cast<Big_int::word_type>(_divide_by_word(data, BIG_INT_BASE));
+	}
+	Big_int ret;
+	for (std::size_t i = size; i != 0; --i) {
+		ret.shift_limbs(1);
+		ret.add_word(chunks[i - 1]);
+	}
+	if (_sign) {
+		ret.negate();
+	}
+	return ret;
+}
+
+template <std::size_t Bits>
+constexpr Fixed_int<Bits>& Fixed_int<Bits>::negate()
+{
+	_sign = !_sign;
+	_correct_sign();
+	return *this;
+}
+
+template <std::size_t Bits>
+constexpr Fixed_int<Bits>::operator bool() const
+{
+	return _size(_data) != 0;
+}
+
+template <std::size_t Bits>
+constexpr Fixed_int<Bits> Fixed_int<Bits>::max()
+{
+	Fixed_int ret;
+	for (auto& limb : ret._data) {
+		limb = ~limb_type(0);
+	}
+	return ret;
+}
+
+template <std::size_t Bits>
+std::ostream& operator<<(std::ostream& os, const Fixed_int<Bits>& number)
+{
+	return os << number.to_string();
+}
+
+#endif
@@ -0,0 +1,296 @@
+#ifndef LIMB_KERNELS_H
+#define LIMB_KERNELS_H
+
+#include <bit>
+#include <cstddef>
+
+#if (defined(__x86_64__) or defined(__i386__)) and defined(__GNUC__)
+#define LIMB_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+/// Instruction sets of Limb_kernels, in the order of preference.
+enum class Simd_level
+{
+	scalar,
+	sse4,
+	avx2
+};
+
+/// Best level supported by the CPU, checked at run time.
+inline Simd_level supported_simd_level()
+{
+#ifdef LIMB_KERNELS_X86
+	if (__builtin_cpu_supports("avx2")) {
+		return Simd_level::avx2;
+	}
+	if (__builtin_cpu_supports("sse4.1")) {
+		return Simd_level::sse4;
+	}
+#endif
+	return Simd_level::scalar;
+}
+
+/// Addition, subtraction and comparison of equal-length arrays of limbs
+/// in base Base, least significant limb first.
+///
+/// The vector kernels add a block of limbs lane-wise, then resolve the carries
+/// of the whole block at once by carry-lookahead: lane i generates a carry if
+/// its sum is at least Base and propagates the incoming one if its sum is
+/// Base - 1. With the generate bits in g and the propagate bits in p, the
+/// carries into the lanes are the carries of the binary sum (g | p) + g + c.
+/// So the only serial dependency is one integer addition per block,
+/// instead of a compare and branch per limb.
+template <unsigned int Base>
+class Limb_kernels
+{
+	// Lane sums stay below 2^31, so signed vector comparisons work.
+	static_assert(Base >= 2 and Base <= (1u << 30));
+
+public:
+	using limb_type = unsigned int;
+	using size_type = std::size_t;
+
+	/// _result[0, _size) = _lhs + _rhs + _carry. Return the carry out.
+	/// _result may be the same array as _lhs or _rhs.
+	static limb_type add(	limb_type* _result, const limb_type* _lhs, const limb_type* _rhs,
+							size_type _size, limb_type _carry, Simd_level _level)
+	{
+		switch (_level) {
+#ifdef LIMB_KERNELS_X86
+		case Simd_level::avx2:
+			return _add_avx2(_result, _lhs, _rhs, _size, _carry);
+		case Simd_level::sse4:
+			return _add_sse4(_result, _lhs, _rhs, _size, _carry);
+#endif
+		default:
+			return _add_scalar(_result, _lhs, _rhs, _size, _carry, 0);
+		}
+	}
+
+	/// _result[0, _size) = _lhs - _rhs - _borrow mod Base^_size. Return the borrow out.
+	/// _result may be the same array as _lhs or _rhs.
+	static limb_type subtract(	limb_type* _result, const limb_type* _lhs, const limb_type* _rhs,
+								size_type _size, limb_type _borrow, Simd_level _level)
+	{
+		switch (_level) {
+#ifdef LIMB_KERNELS_X86
+		case Simd_level::avx2:
+			return _subtract_avx2(_result, _lhs, _rhs, _size, _borrow);
+		case Simd_level::sse4:
+			return _subtract_sse4(_result, _lhs, _rhs, _size, _borrow);
+#endif
+		default:
+			return _subtract_scalar(_result, _lhs, _rhs, _size, _borrow, 0);
+		}
+	}
+
+	/// Similar to strcmp from C for the numbers _lhs[0, _size) and _rhs[0, _size).
+	static int compare(const limb_type* _lhs, const limb_type* _rhs, size_type _size, Simd_level _level)
+	{
+		switch (_level) {
+#ifdef LIMB_KERNELS_X86
+		case Simd_level::avx2:
+			return _compare_avx2(_lhs, _rhs, _size);
+		case Simd_level::sse4:
+			return _compare_sse4(_lhs, _rhs, _size);
+#endif
+		default:
+			return _compare_scalar(_lhs, _rhs, _size);
+		}
+	}
+
+private:
+	/// Limbs [_first, _size) one at a time.
+	static limb_type _add_scalar(	limb_type* _result, const limb_type* _lhs, const limb_type* _rhs,
+									size_type _size, limb_type _carry, size_type _first)
+	{
+		for (size_type i = _first; i < _size; ++i) {
+			limb_type sum = _lhs[i] + _rhs[i] + _carry;
+			_carry = sum >= Base;
+			_result[i] = _carry ? sum - Base : sum;
+		}
+		return _carry;
+	}
+
+	static limb_type _subtract_scalar(	limb_type* _result, const limb_type* _lhs, const limb_type* _rhs,
+										size_type _size, limb_type _borrow, size_type _first)
+	{
+		for (size_type i = _first; i < _size; ++i) {
+			limb_type rhs_num = _rhs[i] + _borrow;
+			_borrow = _lhs[i] < rhs_num;
+			_result[i] = _borrow ? _lhs[i] + (Base - rhs_num) : _lhs[i] - rhs_num;
+		}
+		return _borrow;
+	}
+
+	/// Compare the limbs [0, _last) from the most significant one.
+	static int _compare_scalar(const limb_type* _lhs, const limb_type* _rhs, size_type _last)
+	{
+		for (size_type i = _last; i != 0; --i) {
+			if (_lhs[i - 1] != _rhs[i - 1]) {
+				return _lhs[i - 1] > _rhs[i - 1] ? 1 : -1;
+			}
+		}
+		return 0;
+	}
+
+	/// Carries into the lanes of a block of _lanes limbs (bit i for lane i)
+	/// from the generate and propagate masks. _carry becomes the carry out.
+	static unsigned int _lookahead(unsigned int _generate, unsigned int _propagate, limb_type& _carry, unsigned int _lanes)
+	{
+		unsigned int x = _generate | _propagate;
+		unsigned int sum = x + _generate + _carry;
+		_carry = sum >> _lanes;
+		return (sum ^ x ^ _generate) & ((1u << _lanes) - 1);
+	}
+
+#ifdef LIMB_KERNELS_X86
+	[[gnu::target("avx2")]]
+	static __m256i _carry_vector_avx2(unsigned int _carries)
+	{
+		// All ones in the lanes with a carry, that is -1.
+		const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+		return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(static_cast<int>(_carries)), bits), bits);
+	}
+
+	[[gnu::target("avx2")]]
+	static unsigned int _mask_avx2(__m256i _lanes)
+	{
+		return static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(_lanes)));
+	}
+
+	[[gnu::target("avx2")]]
+	static limb_type _add_avx2(	limb_type* _result, const limb_type* _lhs, const limb_type* _rhs,
+								size_type _size, limb_type _carry)
+	{
+		const __m256i base = _mm256_set1_epi32(static_cast<int>(Base));
+		const __m256i max_limb = _mm256_set1_epi32(static_cast<int>(Base - 1));
+		size_type i = 0;
+		for (; i + 8 <= _size; i += 8) {
+			__m256i sum = _mm256_add_epi32(
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(_lhs + i)),
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(_rhs + i)));
+			unsigned int carries = _lookahead(
+				_mask_avx2(_mm256_cmpgt_epi32(sum, max_limb)),
+				_mask_avx2(_mm256_cmpeq_epi32(sum, max_limb)),
+				_carry, 8);
+			sum = _mm256_sub_epi32(sum, _carry_vector_avx2(carries));
+			// sum - Base wraps around unless sum >= Base.
+			sum = _mm256_min_epu32(sum, _mm256_sub_epi32(sum, base));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(_result + i), sum);
+		}
+		return _add_scalar(_result, _lhs, _rhs, _size, _carry, i);
+	}
+
+	[[gnu::target("avx2")]]
+	static limb_type _subtract_avx2(limb_type* _result, const limb_type* _lhs, const limb_type* _rhs,
+									size_type _size, limb_type _borrow)
+	{
+		const __m256i base = _mm256_set1_epi32(static_cast<int>(Base));
+		size_type i = 0;
+		for (; i + 8 <= _size; i += 8) {
+			__m256i lhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_lhs + i));
+			__m256i rhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_rhs + i));
+			unsigned int borrows = _lookahead(
+				_mask_avx2(_mm256_cmpgt_epi32(rhs, lhs)),
+				_mask_avx2(_mm256_cmpeq_epi32(rhs, lhs)),
+				_borrow, 8);
+			__m256i difference = _mm256_add_epi32(_mm256_sub_epi32(lhs, rhs), _carry_vector_avx2(borrows));
+			// difference + Base wraps around unless difference is negative.
+			difference = _mm256_min_epu32(difference, _mm256_add_epi32(difference, base));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(_result + i), difference);
+		}
+		return _subtract_scalar(_result, _lhs, _rhs, _size, _borrow, i);
+	}
+
+	[[gnu::target("avx2")]]
+	static int _compare_avx2(const limb_type* _lhs, const limb_type* _rhs, size_type _size)
+	{
+		size_type i = _size;
+		for (; i >= 8; i -= 8) {
+			unsigned int equal = _mask_avx2(_mm256_cmpeq_epi32(
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(_lhs + i - 8)),
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(_rhs + i - 8))));
+			if (equal != 0xFF) {
+				size_type lane = std::bit_width(~equal & 0xFF) - 1;
+				return _lhs[i - 8 + lane] > _rhs[i - 8 + lane] ? 1 : -1;
+			}
+		}
+		return _compare_scalar(_lhs, _rhs, i);
+	}
+
+	[[gnu::target("sse4.1")]]
+	static __m128i _carry_vector_sse4(unsigned int _carries)
+	{
+		const __m128i bits = _mm_setr_epi32(1, 2, 4, 8);
+		return _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(static_cast<int>(_carries)), bits), bits);
+	}
+
+	[[gnu::target("sse4.1")]]
+	static unsigned int _mask_sse4(__m128i _lanes)
+	{
+		return static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(_lanes)));
+	}
+
+	[[gnu::target("sse4.1")]]
+	static limb_type _add_sse4(	limb_type* _result, const limb_type* _lhs, const limb_type* _rhs,
+								size_type _size, limb_type _carry)
+	{
+		const __m128i base = _mm_set1_epi32(static_cast<int>(Base));
+		const __m128i max_limb = _mm_set1_epi32(static_cast<int>(Base - 1));
+		size_type i = 0;
+		for (; i + 4 <= _size; i += 4) {
+			__m128i sum = _mm_add_epi32(
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(_lhs + i)),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(_rhs + i)));
+			unsigned int carries = _lookahead(
+				_mask_sse4(_mm_cmpgt_epi32(sum, max_limb)),
+				_mask_sse4(_mm_cmpeq_epi32(sum, max_limb)),
+				_carry, 4);
+			sum = _mm_sub_epi32(sum, _carry_vector_sse4(carries));
+			sum = _mm_min_epu32(sum, _mm_sub_epi32(sum, base));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(_result + i), sum);
+		}
+		return _add_scalar(_result, _lhs, _rhs, _size, _carry, i);
+	}
+
+	[[gnu::target("sse4.1")]]
+	static limb_type _subtract_sse4(limb_type* _result, const limb_type* _lhs, const limb_type* _rhs,
+									size_type _size, limb_type _borrow)
+	{
+		const __m128i base = _mm_set1_epi32(static_cast<int>(Base));
+		size_type i = 0;
+		for (; i + 4 <= _size; i += 4) {
+			__m128i lhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_lhs + i));
+			__m128i rhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_rhs + i));
+			unsigned int borrows = _lookahead(
+				_mask_sse4(_mm_cmpgt_epi32(rhs, lhs)),
+				_mask_sse4(_mm_cmpeq_epi32(rhs, lhs)),
+				_borrow, 4);
+			__m128i difference = _mm_add_epi32(_mm_sub_epi32(lhs, rhs), _carry_vector_sse4(borrows));
+			difference = _mm_min_epu32(difference, _mm_add_epi32(difference, base));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(_result + i), difference);
+		}
+		return _subtract_scalar(_result, _lhs, _rhs, _size, _borrow, i);
+	}
+
+	[[gnu::target("sse4.1")]]
+	static int _compare_sse4(const limb_type* _lhs, const limb_type* _rhs, size_type _size)
+	{
+		size_type i = _size;
+		for (; i >= 4; i -= 4) {
+			unsigned int equal = _mask_sse4(_mm_cmpeq_epi32(
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(_lhs + i - 4)),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(_rhs + i - 4))));
+			if (equal != 0xF) {
+				size_type lane = std::bit_width(~equal & 0xF) - 1;
+				return _lhs[i - 4 + lane] > _rhs[i - 4 + lane] ? 1 : -1;
+			}
+		}
+		return _compare_scalar(_lhs, _rhs, i);
+	}
+#endif
+};
+
+#endif
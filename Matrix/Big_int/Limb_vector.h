@@ -0,0 +1,347 @@
+#ifndef LIMB_VECTOR_H
+#define LIMB_VECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+/// Memory resource of the heap buffers of the Limb_vectors constructed on the
+/// calling thread, nullptr (the default) for operator new[].
+inline std::pmr::memory_resource*& current_limb_resource() noexcept
+{
+	thread_local std::pmr::memory_resource* resource = nullptr;
+	return resource;
+}
+
+/// Vector of trivially copyable limbs with inline storage for Inline_size limbs.
+/// The heap is used only when the size grows past Inline_size,
+/// so small numbers are copied and destroyed without allocation.
+///
+/// Like the std::pmr containers, a vector keeps the memory resource it is
+/// constructed with (current_limb_resource() at that moment, also for copies)
+/// and a move assignment from a vector with another resource copies the limbs.
+template <typename T, std::size_t Inline_size>
+class Limb_vector
+{
+	static_assert(std::is_trivially_copyable_v<T>, "Limbs are moved by memcpy");
+	static_assert(Inline_size > 0);
+
+public:
+	using value_type = T;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = T&;
+	using const_reference = const T&;
+	using pointer = T*;
+	using const_pointer = const T*;
+	using iterator = T*;
+	using const_iterator = const T*;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	Limb_vector() noexcept
+		: _data(_inline)
+		, _size(0)
+		, _capacity(Inline_size)
+		, _resource(current_limb_resource()) {}
+
+	explicit Limb_vector(size_type count) : Limb_vector(count, T()) {}
+
+	Limb_vector(size_type count, const T& value) : Limb_vector()
+	{
+		assign(count, value);
+	}
+
+	template
+	<
+		typename InIt,
+		std::enable_if_t<
+			std::is_base_of_v<
+			std::input_iterator_tag,
+			typename std::iterator_traits<InIt>::iterator_category>, int> = 0
+	>
+	Limb_vector(InIt first, InIt last) : Limb_vector()
+	{
+		for (; first != last; ++first) {
+			push_back(*first);
+		}
+	}
+
+	Limb_vector(std::initializer_list<T> init) : Limb_vector(init.begin(), init.end()) {}
+
+	Limb_vector(const Limb_vector& other) : Limb_vector()
+	{
+		reserve(other._size);
+		_copy(_data, other._data, other._size);
+		_size = other._size;
+	}
+
+	/// Steal the heap buffer of other, copy the inline limbs.
+	Limb_vector(Limb_vector&& other) noexcept : Limb_vector()
+	{
+		_steal(other);
+	}
+
+	~Limb_vector()
+	{
+		_deallocate();
+	}
+
+	/// Reuse the capacity of *this if it is large enough.
+	Limb_vector& operator=(const Limb_vector& other)
+	{
+		if (this != &other) {
+			_size = 0;
+			reserve(other._size);
+			_copy(_data, other._data, other._size);
+			_size = other._size;
+		}
+		return *this;
+	}
+
+	/// Copy if the heap buffer of other comes from another memory resource.
+	Limb_vector& operator=(Limb_vector&& other)
+	{
+		if (other._data != other._inline and other._resource != _resource) {
+			*this = other;
+			other._size = 0;
+		}
+		else if (this != &other) {
+			_deallocate();
+			_data = _inline;
+			_size = 0;
+			_capacity = Inline_size;
+			_steal(other);
+		}
+		return *this;
+	}
+
+	void swap(Limb_vector& other)
+	{
+		Limb_vector temp(std::move(other));
+		other = std::move(*this);
+		*this = std::move(temp);
+	}
+
+	[[nodiscard]] T& operator[](size_type index) noexcept { return _data[index]; }
+	[[nodiscard]] const T& operator[](size_type index) const noexcept { return _data[index]; }
+
+	[[nodiscard]] T& front() noexcept { return _data[0]; }
+	[[nodiscard]] const T& front() const noexcept { return _data[0]; }
+
+	[[nodiscard]] T& back() noexcept { return _data[_size - 1]; }
+	[[nodiscard]] const T& back() const noexcept { return _data[_size - 1]; }
+
+	[[nodiscard]] T* data() noexcept { return _data; }
+	[[nodiscard]] const T* data() const noexcept { return _data; }
+
+	[[nodiscard]] iterator begin() noexcept { return _data; }
+	[[nodiscard]] const_iterator begin() const noexcept { return _data; }
+	[[nodiscard]] const_iterator cbegin() const noexcept { return _data; }
+	[[nodiscard]] iterator end() noexcept { return _data + _size; }
+	[[nodiscard]] const_iterator end() const noexcept { return _data + _size; }
+	[[nodiscard]] const_iterator cend() const noexcept { return _data + _size; }
+
+	[[nodiscard]] reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+	[[nodiscard]] const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+	[[nodiscard]] reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+	[[nodiscard]] const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+	[[nodiscard]] bool empty() const noexcept { return _size == 0; }
+	[[nodiscard]] size_type size() const noexcept { return _size; }
+	[[nodiscard]] size_type capacity() const noexcept { return _capacity; }
+
+	/// True while the limbs are stored in the object itself.
+	[[nodiscard]] bool is_inline() const noexcept { return _data == _inline; }
+
+	/// Memory resource of the heap buffer, nullptr for operator new[].
+	[[nodiscard]] std::pmr::memory_resource* resource() const noexcept { return _resource; }
+
+	void reserve(size_type new_capacity)
+	{
+		if (new_capacity > _capacity) {
+			_reallocate(new_capacity);
+		}
+	}
+
+	void clear() noexcept
+	{
+		_size = 0;
+	}
+
+	void push_back(const T& value)
+	{
+		if (_size == _capacity) {
+			T temp = value; // value can refer to an element of *this
+			_grow(_size + 1);
+			_data[_size++] = temp;
+		}
+		else {
+			_data[_size++] = value;
+		}
+	}
+
+	void pop_back() noexcept
+	{
+		--_size;
+	}
+
+	void resize(size_type count)
+	{
+		resize(count, T());
+	}
+
+	void resize(size_type count, const T& value)
+	{
+		if (count > _size) {
+			T temp = value;
+			_grow(count);
+			std::fill(_data + _size, _data + count, temp);
+		}
+		_size = count;
+	}
+
+	void assign(size_type count, const T& value)
+	{
+		T temp = value;
+		_size = 0;
+		reserve(count);
+		std::fill_n(_data, count, temp);
+		_size = count;
+	}
+
+	iterator insert(const_iterator pos, size_type count, const T& value)
+	{
+		size_type index = pos - _data;
+		T temp = value;
+		_grow(_size + count);
+		std::memmove(_data + index + count, _data + index, (_size - index) * sizeof(T));
+		std::fill_n(_data + index, count, temp);
+		_size += count;
+		return _data + index;
+	}
+
+	iterator erase(const_iterator first, const_iterator last) noexcept
+	{
+		size_type index = first - _data;
+		size_type count = last - first;
+		std::memmove(_data + index, _data + index + count, (_size - index - count) * sizeof(T));
+		_size -= count;
+		return _data + index;
+	}
+
+	[[nodiscard]] bool operator==(const Limb_vector& other) const noexcept
+	{
+		return std::equal(begin(), end(), other.begin(), other.end());
+	}
+
+private:
+	T* _data;			// _inline or a heap buffer of _capacity limbs
+	size_type _size;
+	size_type _capacity;
+	std::pmr::memory_resource* _resource;
+	T _inline[Inline_size];
+
+	static void _copy(T* dest, const T* src, size_type count) noexcept
+	{
+		if (count != 0) {
+			std::memcpy(dest, src, count * sizeof(T));
+		}
+	}
+
+	/// Make room for at least min_capacity limbs with geometric growth.
+	void _grow(size_type min_capacity)
+	{
+		if (min_capacity > _capacity) {
+			_reallocate(std::max(min_capacity, 2 * _capacity));
+		}
+	}
+
+	void _reallocate(size_type new_capacity)
+	{
+		T* new_data = _resource
+			? static_cast<T*>(_resource->allocate(new_capacity * sizeof(T), alignof(T)))
+			: new T[new_capacity];
+		_copy(new_data, _data, _size);
+		_deallocate();
+		_data = new_data;
+		_capacity = new_capacity;
+	}
+
+	void _deallocate() noexcept
+	{
+		if (_data == _inline) {
+			return;
+		}
+		if (_resource) {
+			_resource->deallocate(_data, _capacity * sizeof(T), alignof(T));
+		}
+		else {
+			delete[] _data;
+		}
+	}
+
+	/// Requires *this to be empty and inline.
+	void _steal(Limb_vector& other) noexcept
+	{
+		if (other._data == other._inline) {
+			_copy(_inline, other._inline, other._size);
+		}
+		else {
+			_data = other._data;
+			_capacity = other._capacity;
+			_resource = other._resource;
+			other._data = other._inline;
+			other._capacity = Inline_size;
+		}
+		_size = other._size;
+		other._size = 0;
+	}
+};
+
+template <typename T, std::size_t Inline_size>
+void swap(Limb_vector<T, Inline_size>& lhs, Limb_vector<T, Inline_size>& rhs)
+{
+	lhs.swap(rhs);
+}
+
+/// Bump allocator for the limbs of all numbers constructed on the calling
+/// thread while it exists. The memory is released at once on destruction,
+/// so numbers constructed in the scope must not outlive it. Numbers
+/// constructed before the scope keep their storage, also when a result
+/// is assigned to them:
+///
+///     Rational det;
+///     {
+///         Scoped_limb_arena arena;
+///         det = matrix.det();
+///     }
+///
+/// Arenas nest. An arena is not synchronized, so Big_int multiplication does
+/// not start threads while one is installed.
+class Scoped_limb_arena
+{
+public:
+	explicit Scoped_limb_arena(std::size_t initial_size = 64 * 1024)
+		: _arena(initial_size)
+		, _previous(std::exchange(current_limb_resource(), &_arena)) {}
+
+	~Scoped_limb_arena()
+	{
+		current_limb_resource() = _previous;
+	}
+
+	Scoped_limb_arena(const Scoped_limb_arena&) = delete;
+	Scoped_limb_arena& operator=(const Scoped_limb_arena&) = delete;
+
+private:
+	std::pmr::monotonic_buffer_resource _arena;
+	std::pmr::memory_resource* _previous;
+};
+
+#endif
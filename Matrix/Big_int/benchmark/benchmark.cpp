@@ -0,0 +1,1089 @@
+#include <limits>
+#include <optional>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "benchmark/benchmark.h"
+
+#include "../Big_int.h"
+#include "../Big_int.cpp"
+#include "../Big_int_expression.h"
+#include "../Big_uint.h"
+#include "../Fixed_int.h"
+#include "../rational.h"
+#include "../rational.cpp"
+#include "../modular.h"
+#include "../modular.cpp"
+#include "../combinatorics.h"
+#include "../combinatorics.cpp"
+#include "../serialization.h"
+#include "../serialization.cpp"
+#include "../../matrix.h"
+
+// Build: g++ -std=c++20 -O2 benchmark.cpp -lbenchmark -lpthread
+
+Big_int random_big_int(size_t digits, std::mt19937& gen)
+{
+	std::uniform_int_distribution<int> dist('0', '9');
+	std::string str(digits, '0');
+	for (auto& c : str) {
+		c = static_cast<char>(dist(gen));
+	}
+	str.front() = '1' + dist(gen) % 9;
+	return Big_int(str);
+}
+
+/// Restore Big_int thresholds after a benchmark changed them.
+class Threshold_guard
+{
+public:
+	Threshold_guard()
+		: _karatsuba_threshold(Big_int::karatsuba_threshold)
+		, _toom3_threshold(Big_int::toom3_threshold)
+		, _ntt_threshold(Big_int::ntt_threshold)
+		, _newton_division_threshold(Big_int::newton_division_threshold) {}
+
+	~Threshold_guard()
+	{
+		Big_int::karatsuba_threshold = _karatsuba_threshold;
+		Big_int::toom3_threshold = _toom3_threshold;
+		Big_int::ntt_threshold = _ntt_threshold;
+		Big_int::newton_division_threshold = _newton_division_threshold;
+	}
+
+private:
+	size_t _karatsuba_threshold;
+	size_t _toom3_threshold;
+	size_t _ntt_threshold;
+	size_t _newton_division_threshold;
+};
+
+//++++++++++++++++++++Addition and subtraction++++++++++++++++++++
+// state.range(0) is the operand size in limbs,
+// state.range(1) is the Simd_level (0 scalar, 1 SSE4.1, 2 AVX2).
+
+/// Skip the levels the CPU does not support.
+bool set_simd_level(benchmark::State& state)
+{
+	if (state.range(1) > static_cast<int>(supported_simd_level())) {
+		state.SkipWithError("Unsupported SIMD level");
+		return false;
+	}
+	Big_int::simd_level = static_cast<Simd_level>(state.range(1));
+	return true;
+}
+
+void BM_add(benchmark::State& state)
+{
+	if (!set_simd_level(state)) {
+		return;
+	}
+	std::mt19937 gen(1);
+	Big_int a = random_big_int(state.range(0) * 9, gen);
+	Big_int b = random_big_int(state.range(0) * 9, gen);
+	for (auto _ : state) {
+		a += b;
+		benchmark::DoNotOptimize(a);
+	}
+	Big_int::simd_level = supported_simd_level();
+}
+BENCHMARK(BM_add)->ArgsProduct({ { 16, 256, 4'096, 65'536 }, { 0, 1, 2 } });
+
+void BM_subtract(benchmark::State& state)
+{
+	if (!set_simd_level(state)) {
+		return;
+	}
+	std::mt19937 gen(1);
+	Big_int a = random_big_int(state.range(0) * 9 + 1, gen);
+	Big_int b = random_big_int(state.range(0) * 9, gen);
+	for (auto _ : state) {
+		a -= b;
+		a += b;
+		benchmark::DoNotOptimize(a);
+	}
+	Big_int::simd_level = supported_simd_level();
+}
+BENCHMARK(BM_subtract)->ArgsProduct({ { 16, 256, 4'096, 65'536 }, { 0, 1, 2 } });
+
+void BM_compare(benchmark::State& state)
+{
+	if (!set_simd_level(state)) {
+		return;
+	}
+	std::mt19937 gen(1);
+	Big_int a = random_big_int(state.range(0) * 9, gen);
+	Big_int b = a + 1;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a < b);
+	}
+	Big_int::simd_level = supported_simd_level();
+}
+BENCHMARK(BM_compare)->ArgsProduct({ { 16, 256, 4'096, 65'536 }, { 0, 1, 2 } });
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+//++++++++++++++++++++Multiplication++++++++++++++++++++++++++++++
+// state.range(0) is the operand size in limbs (9 decimal digits each).
+
+void BM_multiply(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int a = random_big_int(state.range(0) * 9, gen);
+	Big_int b = random_big_int(state.range(0) * 9, gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a * b);
+	}
+}
+BENCHMARK(BM_multiply)->RangeMultiplier(4)->Range(4, 65'536);
+
+void BM_multiply_schoolbook(benchmark::State& state)
+{
+	Threshold_guard guard;
+	Big_int::karatsuba_threshold = std::numeric_limits<size_t>::max();
+	BM_multiply(state);
+}
+BENCHMARK(BM_multiply_schoolbook)->RangeMultiplier(4)->Range(4, 4'096);
+
+void BM_multiply_karatsuba(benchmark::State& state)
+{
+	Threshold_guard guard;
+	Big_int::ntt_threshold = std::numeric_limits<size_t>::max();
+	Big_int::toom3_threshold = std::numeric_limits<size_t>::max();
+	BM_multiply(state);
+}
+BENCHMARK(BM_multiply_karatsuba)->RangeMultiplier(4)->Range(4, 16'384);
+
+/// state.range(1) is the tested karatsuba_threshold.
+void BM_karatsuba_threshold(benchmark::State& state)
+{
+	Threshold_guard guard;
+	Big_int::karatsuba_threshold = state.range(1);
+	Big_int::toom3_threshold = std::numeric_limits<size_t>::max();
+	Big_int::ntt_threshold = std::numeric_limits<size_t>::max();
+	BM_multiply(state);
+}
+BENCHMARK(BM_karatsuba_threshold)->ArgsProduct({ { 256, 1'024 }, { 16, 24, 32, 40, 48, 64, 96 } });
+
+/// state.range(1) is the tested toom3_threshold.
+void BM_toom3_threshold(benchmark::State& state)
+{
+	Threshold_guard guard;
+	Big_int::toom3_threshold = state.range(1);
+	Big_int::ntt_threshold = std::numeric_limits<size_t>::max();
+	BM_multiply(state);
+}
+BENCHMARK(BM_toom3_threshold)->ArgsProduct({ { 1'024, 4'096 }, { 80, 120, 160, 240, 320, 640 } });
+
+void BM_multiply_toom3(benchmark::State& state)
+{
+	Threshold_guard guard;
+	Big_int::ntt_threshold = std::numeric_limits<size_t>::max();
+	BM_multiply(state);
+}
+BENCHMARK(BM_multiply_toom3)->RangeMultiplier(4)->Range(256, 65'536);
+
+void BM_multiply_ntt(benchmark::State& state)
+{
+	Threshold_guard guard;
+	Big_int::ntt_threshold = 1;
+	BM_multiply(state);
+}
+BENCHMARK(BM_multiply_ntt)->RangeMultiplier(4)->Range(256, 65'536);
+
+/// state.range(1) is the tested ntt_threshold.
+void BM_ntt_threshold(benchmark::State& state)
+{
+	Threshold_guard guard;
+	Big_int::ntt_threshold = state.range(1);
+	BM_multiply(state);
+}
+BENCHMARK(BM_ntt_threshold)->ArgsProduct({ { 2'048, 8'192 }, { 500, 1'000, 1'500, 3'000, 6'000 } });
+
+/// state.range(1) is the tested thread_count. Only meaningful on a machine with that many cores.
+void BM_multiply_threads(benchmark::State& state)
+{
+	Threshold_guard guard;
+	const size_t thread_count = Big_int::thread_count;
+	Big_int::thread_count = state.range(1);
+	std::mt19937 gen(1);
+	Big_int a = random_big_int(state.range(0) * 9, gen);
+	Big_int b = random_big_int(state.range(0) * 9, gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a * b);
+	}
+	Big_int::thread_count = thread_count;
+}
+BENCHMARK(BM_multiply_threads)->ArgsProduct({ { 16'384, 262'144 }, { 1, 2, 4, 8 } })->UseRealTime()->Unit(benchmark::kMillisecond);
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+//++++++++++++++++++++Squaring++++++++++++++++++++++++++++++++++++
+// Compare with BM_multiply of the same operand size.
+
+void BM_square(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int a = random_big_int(state.range(0) * 9, gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(square(a));
+	}
+}
+BENCHMARK(BM_square)->RangeMultiplier(4)->Range(4, 65'536);
+
+void BM_square_schoolbook(benchmark::State& state)
+{
+	Threshold_guard guard;
+	Big_int::karatsuba_threshold = std::numeric_limits<size_t>::max();
+	BM_square(state);
+}
+BENCHMARK(BM_square_schoolbook)->RangeMultiplier(4)->Range(4, 1'024);
+
+void BM_square_karatsuba(benchmark::State& state)
+{
+	Threshold_guard guard;
+	Big_int::ntt_threshold = std::numeric_limits<size_t>::max();
+	Big_int::toom3_threshold = std::numeric_limits<size_t>::max();
+	BM_square(state);
+}
+BENCHMARK(BM_square_karatsuba)->RangeMultiplier(4)->Range(64, 4'096);
+
+/// Multiplication of equal values stored in different objects, without the squaring kernels.
+void BM_multiply_equal(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int a = random_big_int(state.range(0) * 9, gen);
+	Big_int b = a;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a * b);
+	}
+}
+BENCHMARK(BM_multiply_equal)->RangeMultiplier(4)->Range(4, 65'536);
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+//++++++++++++++++++++Sum of products+++++++++++++++++++++++++++++
+// a * b + c * d, state.range(0) is the operand size in limbs.
+
+void BM_sum_of_products(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int a = random_big_int(state.range(0) * 9, gen);
+	Big_int b = random_big_int(state.range(0) * 9, gen);
+	Big_int c = random_big_int(state.range(0) * 9, gen);
+	Big_int d = random_big_int(state.range(0) * 9, gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a * b + c * d);
+	}
+}
+BENCHMARK(BM_sum_of_products)->RangeMultiplier(2)->Range(2, 64);
+
+void BM_sum_of_products_lazy(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int a = random_big_int(state.range(0) * 9, gen);
+	Big_int b = random_big_int(state.range(0) * 9, gen);
+	Big_int c = random_big_int(state.range(0) * 9, gen);
+	Big_int d = random_big_int(state.range(0) * 9, gen);
+	for (auto _ : state) {
+		Big_int r = lazy(a) * b + lazy(c) * d;
+		benchmark::DoNotOptimize(r);
+	}
+}
+BENCHMARK(BM_sum_of_products_lazy)->RangeMultiplier(2)->Range(2, 64);
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+//++++++++++++++++++++Division++++++++++++++++++++++++++++++++++++
+// state.range(0) is the divisor size in limbs, the dividend is twice as long.
+
+void BM_divide(benchmark::State& state)
+{
+	std::mt19937 gen(2);
+	Big_int a = random_big_int(state.range(0) * 18, gen);
+	Big_int b = random_big_int(state.range(0) * 9, gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a / b);
+	}
+}
+BENCHMARK(BM_divide)->RangeMultiplier(4)->Range(4, 16'384);
+
+void BM_divide_schoolbook(benchmark::State& state)
+{
+	Threshold_guard guard;
+	Big_int::newton_division_threshold = std::numeric_limits<size_t>::max();
+	BM_divide(state);
+}
+BENCHMARK(BM_divide_schoolbook)->RangeMultiplier(2)->Range(256, 16'384);
+
+void BM_divide_newton(benchmark::State& state)
+{
+	Threshold_guard guard;
+	Big_int::newton_division_threshold = 256;
+	BM_divide(state);
+}
+BENCHMARK(BM_divide_newton)->RangeMultiplier(2)->Range(256, 16'384);
+
+void BM_remainder(benchmark::State& state)
+{
+	std::mt19937 gen(2);
+	Big_int a = random_big_int(state.range(0) * 18, gen);
+	Big_int b = random_big_int(state.range(0) * 9, gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a % b);
+	}
+}
+BENCHMARK(BM_remainder)->RangeMultiplier(4)->Range(4, 4'096);
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+//++++++++++++++++++++Modular exponentiation++++++++++++++++++++++
+// state.range(0) is the size of the modulus and of the exponent in bits.
+
+/// base^exponent % modulus by binary exponentiation with operator%.
+Big_int naive_pow_mod(Big_int base, Big_int exponent, const Big_int& modulus)
+{
+	Big_int ret = 1;
+	base %= modulus;
+	while (exponent) {
+		auto [half, bit] = divmod(exponent, 2);
+		if (bit) {
+			ret = ret * base % modulus;
+		}
+		base = base * base % modulus;
+		exponent = std::move(half);
+	}
+	return ret;
+}
+
+void BM_pow_mod(benchmark::State& state)
+{
+	std::mt19937 gen(6);
+	size_t digits = state.range(0) * 30'103 / 100'000; // log10(2)
+	Big_int modulus = random_big_int(digits, gen);
+	Big_int base = random_big_int(digits - 1, gen);
+	Big_int exponent = random_big_int(digits, gen);
+	Modular_context context(modulus);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(context.pow(base, exponent));
+	}
+}
+BENCHMARK(BM_pow_mod)->Arg(2'048)->Arg(4'096)->Unit(benchmark::kMillisecond);
+
+void BM_pow_mod_naive(benchmark::State& state)
+{
+	std::mt19937 gen(6);
+	size_t digits = state.range(0) * 30'103 / 100'000;
+	Big_int modulus = random_big_int(digits, gen);
+	Big_int base = random_big_int(digits - 1, gen);
+	Big_int exponent = random_big_int(digits, gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(naive_pow_mod(base, exponent, modulus));
+	}
+}
+BENCHMARK(BM_pow_mod_naive)->Arg(2'048)->Arg(4'096)->Unit(benchmark::kMillisecond);
+
+/// Reduction of a product of two reduced values.
+void BM_modular_reduce(benchmark::State& state)
+{
+	std::mt19937 gen(6);
+	size_t digits = state.range(0) * 30'103 / 100'000;
+	Big_int modulus = random_big_int(digits, gen);
+	Big_int product = random_big_int(digits - 1, gen) * random_big_int(digits - 1, gen);
+	Modular_context context(modulus);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(context.reduce(product));
+	}
+}
+BENCHMARK(BM_modular_reduce)->Arg(2'048)->Arg(4'096);
+
+void BM_modular_reduce_naive(benchmark::State& state)
+{
+	std::mt19937 gen(6);
+	size_t digits = state.range(0) * 30'103 / 100'000;
+	Big_int modulus = random_big_int(digits, gen);
+	Big_int product = random_big_int(digits - 1, gen) * random_big_int(digits - 1, gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(product % modulus);
+	}
+}
+BENCHMARK(BM_modular_reduce_naive)->Arg(2'048)->Arg(4'096);
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+//++++++++++++++++++++GCD+++++++++++++++++++++++++++++++++++++++++
+// state.range(0) is the size of both operands in decimal digits.
+
+/// Euclid's algorithm with a long division every step.
+Big_int euclid_gcd(Big_int m, Big_int n)
+{
+	while (n) {
+		m %= n;
+		m.swap(n);
+	}
+	return m;
+}
+
+void BM_gcd(benchmark::State& state)
+{
+	std::mt19937 gen(7);
+	Big_int a = random_big_int(state.range(0), gen);
+	Big_int b = random_big_int(state.range(0), gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(gcd(a, b));
+	}
+}
+BENCHMARK(BM_gcd)->RangeMultiplier(10)->Range(10, 10'000);
+
+void BM_gcd_euclid(benchmark::State& state)
+{
+	std::mt19937 gen(7);
+	Big_int a = random_big_int(state.range(0), gen);
+	Big_int b = random_big_int(state.range(0), gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(euclid_gcd(a, b));
+	}
+}
+BENCHMARK(BM_gcd_euclid)->RangeMultiplier(10)->Range(10, 10'000);
+
+void BM_xgcd(benchmark::State& state)
+{
+	std::mt19937 gen(7);
+	Big_int a = random_big_int(state.range(0), gen);
+	Big_int b = random_big_int(state.range(0), gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(xgcd(a, b));
+	}
+}
+BENCHMARK(BM_xgcd)->RangeMultiplier(10)->Range(10, 10'000);
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+//++++++++++++++++++++Roots+++++++++++++++++++++++++++++++++++++++
+// state.range(0) is the size of the number in decimal digits.
+
+/// floor(number^(1 / degree)) by bisection over the bits of the root.
+Big_int iroot_bisection(const Big_int& number, unsigned long long degree)
+{
+	Big_int low = 0;
+	Big_int high = 1;
+	while (pow(high, degree) <= number) {
+		high *= 2;
+	}
+	while (high - low > 1) {
+		Big_int middle = (low + high) / 2;
+		if (pow(middle, degree) <= number) {
+			low = std::move(middle);
+		}
+		else {
+			high = std::move(middle);
+		}
+	}
+	return low;
+}
+
+void BM_isqrt(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int a = random_big_int(state.range(0), gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(isqrt(a));
+	}
+}
+BENCHMARK(BM_isqrt)->RangeMultiplier(10)->Range(100, 100'000);
+
+void BM_isqrt_bisection(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int a = random_big_int(state.range(0), gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(iroot_bisection(a, 2));
+	}
+}
+BENCHMARK(BM_isqrt_bisection)->RangeMultiplier(10)->Range(100, 10'000);
+
+void BM_iroot_5(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int a = random_big_int(state.range(0), gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(iroot(a, 5));
+	}
+}
+BENCHMARK(BM_iroot_5)->RangeMultiplier(10)->Range(100, 100'000);
+
+void BM_iroot_5_bisection(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int a = random_big_int(state.range(0), gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(iroot_bisection(a, 5));
+	}
+}
+BENCHMARK(BM_iroot_5_bisection)->RangeMultiplier(10)->Range(100, 10'000);
+
+/// Random numbers are rejected by the residues, squares need isqrt.
+void BM_is_perfect_square(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int a = random_big_int(state.range(0), gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(is_perfect_square(a));
+	}
+}
+BENCHMARK(BM_is_perfect_square)->RangeMultiplier(10)->Range(100, 100'000);
+
+void BM_is_perfect_square_square(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int a = square(random_big_int(state.range(0) / 2, gen));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(is_perfect_square(a));
+	}
+}
+BENCHMARK(BM_is_perfect_square_square)->RangeMultiplier(10)->Range(100, 100'000);
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+//++++++++++++++++++++Combinatorics+++++++++++++++++++++++++++++++
+// state.range(0) is n.
+
+/// n! by multiplying the running product by every factor.
+Big_int naive_factorial(unsigned long long n)
+{
+	Big_int ret = 1;
+	for (unsigned long long i = 2; i <= n; ++i) {
+		ret.mul_word(static_cast<Big_int::word_type>(i));
+	}
+	return ret;
+}
+
+void BM_factorial(benchmark::State& state)
+{
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(factorial(state.range(0)));
+	}
+}
+BENCHMARK(BM_factorial)->RangeMultiplier(10)->Range(10'000, 1'000'000)->Unit(benchmark::kMillisecond);
+
+void BM_factorial_naive(benchmark::State& state)
+{
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(naive_factorial(state.range(0)));
+	}
+}
+BENCHMARK(BM_factorial_naive)->RangeMultiplier(10)->Range(10'000, 100'000)->Unit(benchmark::kMillisecond);
+
+void BM_binomial(benchmark::State& state)
+{
+	unsigned long long n = state.range(0);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(binomial(n, n / 2));
+	}
+}
+BENCHMARK(BM_binomial)->RangeMultiplier(10)->Range(10'000, 1'000'000)->Unit(benchmark::kMillisecond);
+
+/// C(n, n / 2) by the factorials.
+void BM_binomial_factorials(benchmark::State& state)
+{
+	unsigned long long n = state.range(0);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(factorial(n) / square(factorial(n / 2)));
+	}
+}
+BENCHMARK(BM_binomial_factorials)->RangeMultiplier(10)->Range(10'000, 100'000)->Unit(benchmark::kMillisecond);
+
+void BM_primorial(benchmark::State& state)
+{
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(primorial(state.range(0)));
+	}
+}
+BENCHMARK(BM_primorial)->RangeMultiplier(10)->Range(10'000, 1'000'000)->Unit(benchmark::kMillisecond);
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+//++++++++++++++++++++Shifts and bitwise operations++++++++++++++
+// state.range(0) is the size of the number in decimal digits,
+// state.range(1) is the shift in bits.
+
+void BM_shift_left(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int a = random_big_int(state.range(0), gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a << state.range(1));
+	}
+}
+BENCHMARK(BM_shift_left)->ArgsProduct({ { 1'000, 100'000 }, { 1, 64, 248, 4'096 } });
+
+/// Multiplication by the power of two computed beforehand.
+void BM_shift_left_multiply(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int a = random_big_int(state.range(0), gen);
+	Big_int power = pow(Big_int(2), state.range(1));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a * power);
+	}
+}
+BENCHMARK(BM_shift_left_multiply)->ArgsProduct({ { 1'000, 100'000 }, { 1, 64, 248, 4'096 } });
+
+void BM_shift_right(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int a = -random_big_int(state.range(0), gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a >> state.range(1));
+	}
+}
+BENCHMARK(BM_shift_right)->ArgsProduct({ { 1'000, 100'000 }, { 1, 64, 248, 4'096 } });
+
+/// Division by the power of two computed beforehand.
+void BM_shift_right_divide(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int a = -random_big_int(state.range(0), gen);
+	Big_int power = pow(Big_int(2), state.range(1));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a / power);
+	}
+}
+BENCHMARK(BM_shift_right_divide)->ArgsProduct({ { 1'000, 100'000 }, { 1, 64, 248, 4'096 } });
+
+// The bitwise operations below take state.range(0) decimal digits.
+
+void BM_to_binary(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int a = random_big_int(state.range(0), gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a.to_binary());
+	}
+}
+BENCHMARK(BM_to_binary)->RangeMultiplier(10)->Range(100, 100'000);
+
+void BM_from_binary(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int::binary_type a = random_big_int(state.range(0), gen).to_binary();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(Big_int::from_binary(a));
+	}
+}
+BENCHMARK(BM_from_binary)->RangeMultiplier(10)->Range(100, 100'000);
+
+/// Two conversions to binary_type and one back.
+void BM_bitwise_xor(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int a = random_big_int(state.range(0), gen);
+	Big_int b = -random_big_int(state.range(0), gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a ^ b);
+	}
+}
+BENCHMARK(BM_bitwise_xor)->RangeMultiplier(10)->Range(100, 100'000);
+
+/// The same operation on binary views kept by the caller.
+void BM_bitwise_xor_binary(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int::binary_type a = random_big_int(state.range(0), gen).to_binary();
+	Big_int::binary_type b = random_big_int(state.range(0), gen).to_binary();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a ^ b);
+	}
+}
+BENCHMARK(BM_bitwise_xor_binary)->RangeMultiplier(10)->Range(100, 100'000);
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+//++++++++++++++++++++Small numbers+++++++++++++++++++++++++++++++
+// Operands of state.range(0) limbs, around the inline storage size of Big_int.
+
+void BM_add_small(benchmark::State& state)
+{
+	std::mt19937 gen(5);
+	Big_int a = random_big_int(state.range(0) * 9, gen);
+	Big_int b = random_big_int(state.range(0) * 9, gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a + b);
+	}
+}
+BENCHMARK(BM_add_small)->DenseRange(1, 6);
+
+void BM_multiply_small(benchmark::State& state)
+{
+	std::mt19937 gen(5);
+	Big_int a = random_big_int(state.range(0) * 9, gen);
+	Big_int b = random_big_int(9, gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a * b);
+	}
+}
+BENCHMARK(BM_multiply_small)->DenseRange(1, 6);
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+//++++++++++++++++++++Fixed_int+++++++++++++++++++++++++++++++++++
+// 60-digit (about 200-bit) operands in Fixed_int<256> and in Big_int,
+// state.range(0) is 0 for Big_int and 1 for Fixed_int<256>.
+
+/// sum += a[i] * b[i] over 64 pairs, then the sum divided by each a[i].
+template <typename Number>
+void dot_product_and_divide(benchmark::State& state)
+{
+	std::mt19937 gen(5);
+	std::vector<Number> a;
+	std::vector<Number> b;
+	for (int i = 0; i < 64; ++i) {
+		a.emplace_back(random_big_int(60, gen));
+		b.emplace_back(random_big_int(15, gen));
+	}
+	for (auto _ : state) {
+		Number sum = 0;
+		for (std::size_t i = 0; i < a.size(); ++i) {
+			sum += a[i] * b[i];
+		}
+		for (const auto& divisor : a) {
+			benchmark::DoNotOptimize(sum / divisor);
+		}
+	}
+}
+
+void BM_dot_product_and_divide(benchmark::State& state)
+{
+	if (state.range(0) == 0) {
+		dot_product_and_divide<Big_int>(state);
+	}
+	else {
+		dot_product_and_divide<Fixed_int<256>>(state);
+	}
+}
+BENCHMARK(BM_dot_product_and_divide)->Arg(0)->Arg(1);
+
+void BM_matrix_product(benchmark::State& state)
+{
+	std::vector<std::vector<int>> values(8, std::vector<int>(8));
+	std::mt19937 gen(5);
+	for (auto& row : values) {
+		for (auto& value : row) {
+			value = static_cast<int>(gen() % 2'000'001) - 1'000'000;
+		}
+	}
+	if (state.range(0) == 0) {
+		Mtx::Square_matrix<8, Big_int> matrix(values);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(matrix * matrix * matrix);
+		}
+	}
+	else {
+		Mtx::Square_matrix<8, Fixed_int<256>> matrix(values);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(matrix * matrix * matrix);
+		}
+	}
+}
+BENCHMARK(BM_matrix_product)->Arg(0)->Arg(1);
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+//++++++++++++++++++++Rational accumulation+++++++++++++++++++++++
+// Harmonic sums 1 + 1/2 + ... + 1/n for n == state.range(0).
+
+void BM_harmonic_sum(benchmark::State& state)
+{
+	for (auto _ : state) {
+		Rational sum;
+		for (int k = 1; k <= state.range(0); ++k) {
+			sum += Rational(1, k);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+}
+BENCHMARK(BM_harmonic_sum)->RangeMultiplier(4)->Range(256, 4'096)->Unit(benchmark::kMillisecond);
+
+void BM_harmonic_sum_accumulator(benchmark::State& state)
+{
+	for (auto _ : state) {
+		Rational_accumulator sum;
+		for (int k = 1; k <= state.range(0); ++k) {
+			sum += Rational(1, k);
+		}
+		benchmark::DoNotOptimize(sum.value());
+	}
+}
+BENCHMARK(BM_harmonic_sum_accumulator)->RangeMultiplier(4)->Range(256, 16'384)->Unit(benchmark::kMillisecond);
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+//++++++++++++++++++++Hashing+++++++++++++++++++++++++++++++++++++
+// Lookups of 1'024 keys of state.range(0) decimal digits, half of them present.
+
+std::vector<Big_int> hash_keys(std::size_t digits)
+{
+	std::mt19937 gen(6);
+	std::vector<Big_int> ret;
+	for (int i = 0; i < 1'024; ++i) {
+		ret.push_back(random_big_int(digits, gen));
+	}
+	return ret;
+}
+
+void BM_hash_map_find(benchmark::State& state)
+{
+	std::vector<Big_int> keys = hash_keys(state.range(0));
+	std::unordered_map<Big_int, int> map;
+	for (std::size_t i = 0; i < keys.size(); i += 2) {
+		map.emplace(keys[i], static_cast<int>(i));
+	}
+	for (auto _ : state) {
+		for (const auto& key : keys) {
+			benchmark::DoNotOptimize(map.find(key));
+		}
+	}
+}
+BENCHMARK(BM_hash_map_find)->RangeMultiplier(10)->Range(10, 10'000);
+
+/// The workaround without std::hash<Big_int>: the map is keyed on to_string().
+void BM_hash_map_find_string(benchmark::State& state)
+{
+	std::vector<Big_int> keys = hash_keys(state.range(0));
+	std::unordered_map<std::string, int> map;
+	for (std::size_t i = 0; i < keys.size(); i += 2) {
+		map.emplace(keys[i].to_string(), static_cast<int>(i));
+	}
+	for (auto _ : state) {
+		for (const auto& key : keys) {
+			benchmark::DoNotOptimize(map.find(key.to_string()));
+		}
+	}
+}
+BENCHMARK(BM_hash_map_find_string)->RangeMultiplier(10)->Range(10, 10'000);
+
+void BM_hash_map_find_rational(benchmark::State& state)
+{
+	std::vector<Big_int> numbers = hash_keys(state.range(0));
+	std::vector<Rational> keys;
+	for (std::size_t i = 0; i + 1 < numbers.size(); i += 2) {
+		keys.emplace_back(numbers[i], numbers[i + 1]);
+	}
+	std::unordered_map<Rational, int> map;
+	for (std::size_t i = 0; i < keys.size(); i += 2) {
+		map.emplace(keys[i], static_cast<int>(i));
+	}
+	for (auto _ : state) {
+		for (const auto& key : keys) {
+			benchmark::DoNotOptimize(map.find(key));
+		}
+	}
+}
+BENCHMARK(BM_hash_map_find_rational)->RangeMultiplier(10)->Range(10, 10'000);
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+//++++++++++++++++++++Arena+++++++++++++++++++++++++++++++++++++++
+// 100 expressions with temporaries of state.range(0) limbs,
+// with a Scoped_limb_arena around them if state.range(1) is 1.
+
+void BM_temporaries(benchmark::State& state)
+{
+	std::mt19937 gen(1);
+	Big_int a = random_big_int(state.range(0) * 9, gen);
+	Big_int b = random_big_int(state.range(0) * 9, gen);
+	Big_int c = random_big_int(state.range(0) * 9, gen);
+	Big_int result;
+	for (auto _ : state) {
+		std::optional<Scoped_limb_arena> arena;
+		if (state.range(1)) {
+			arena.emplace();
+		}
+		for (int i = 0; i < 100; ++i) {
+			result = (a * b + b * c) / (a + c) - b;
+		}
+		benchmark::DoNotOptimize(result);
+	}
+}
+BENCHMARK(BM_temporaries)->ArgsProduct({ { 8, 32, 128 }, { 0, 1 } });
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+//++++++++++++++++++++Conversion++++++++++++++++++++++++++++++++++
+// state.range(0) is the size in decimal digits.
+
+void BM_to_string(benchmark::State& state)
+{
+	std::mt19937 gen(4);
+	Big_int a = random_big_int(state.range(0), gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a.to_string());
+	}
+}
+BENCHMARK(BM_to_string)->RangeMultiplier(10)->Range(100, 1'000'000);
+
+void BM_to_chars(benchmark::State& state)
+{
+	std::mt19937 gen(4);
+	Big_int a = random_big_int(state.range(0), gen);
+	std::string buffer(a.chars_size(), '0');
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(to_chars(buffer.data(), buffer.data() + buffer.size(), a));
+	}
+}
+BENCHMARK(BM_to_chars)->RangeMultiplier(10)->Range(100, 1'000'000);
+
+void BM_from_string(benchmark::State& state)
+{
+	std::mt19937 gen(4);
+	std::string str = random_big_int(state.range(0), gen).to_string();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(Big_int(str));
+	}
+}
+BENCHMARK(BM_from_string)->RangeMultiplier(10)->Range(100, 1'000'000);
+
+// A 30-digit and a 100-digit constant as a _bi literal and parsed at run time.
+void BM_literal(benchmark::State& state)
+{
+	for (auto _ : state) {
+		if (state.range(0) == 30) {
+			benchmark::DoNotOptimize(730750818665451459101842416358_bi);
+		}
+		else {
+			benchmark::DoNotOptimize("3141592653589793238462643383279502884197169399375105820974944592307816406286208998628034825342117067"_bi);
+		}
+	}
+}
+BENCHMARK(BM_literal)->Arg(30)->Arg(100);
+
+void BM_literal_parse(benchmark::State& state)
+{
+	for (auto _ : state) {
+		if (state.range(0) == 30) {
+			benchmark::DoNotOptimize(Big_int("730750818665451459101842416358"));
+		}
+		else {
+			benchmark::DoNotOptimize(Big_int("3141592653589793238462643383279502884197169399375105820974944592307816406286208998628034825342117067"));
+		}
+	}
+}
+BENCHMARK(BM_literal_parse)->Arg(30)->Arg(100);
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+//++++++++++++++++++++Serialization+++++++++++++++++++++++++++++++
+// state.range(0) is the size in decimal digits. Compare with the conversion above.
+
+void BM_serialize(benchmark::State& state)
+{
+	std::mt19937 gen(4);
+	Big_int a = random_big_int(state.range(0), gen);
+	std::vector<std::byte> buffer(serialized_size(a));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(serialize(a, std::span<std::byte>(buffer)));
+	}
+	state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK(BM_serialize)->RangeMultiplier(10)->Range(10, 1'000'000);
+
+void BM_deserialize(benchmark::State& state)
+{
+	std::mt19937 gen(4);
+	std::vector<std::byte> buffer;
+	serialize(random_big_int(state.range(0), gen), buffer);
+	Big_int a;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(deserialize(buffer, a));
+	}
+	state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK(BM_deserialize)->RangeMultiplier(10)->Range(10, 1'000'000);
+
+/// Writing to and reading from a std::stringstream.
+void BM_serialize_stream_round_trip(benchmark::State& state)
+{
+	std::mt19937 gen(4);
+	Big_int a = random_big_int(state.range(0), gen);
+	Big_int b;
+	for (auto _ : state) {
+		std::stringstream stream;
+		serialize(a, stream);
+		deserialize(stream, b);
+		benchmark::DoNotOptimize(b);
+	}
+}
+BENCHMARK(BM_serialize_stream_round_trip)->RangeMultiplier(10)->Range(10, 1'000'000);
+
+/// Decoding every number of a file of 10'000 numbers of state.range(0) digits.
+void BM_mapped_array(benchmark::State& state)
+{
+	std::mt19937 gen(4);
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "big_int_mapped_array_benchmark.bin";
+	{
+		std::ofstream file(path, std::ios::binary);
+		for (int i = 0; i < 10'000; ++i) {
+			serialize(random_big_int(state.range(0), gen), file);
+		}
+	}
+	{
+		Mapped_big_int_array array(path.string());
+		for (auto _ : state) {
+			for (std::size_t i = 0; i < array.size(); ++i) {
+				benchmark::DoNotOptimize(array[i]);
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * array.size());
+	}
+	std::filesystem::remove(path);
+}
+BENCHMARK(BM_mapped_array)->RangeMultiplier(10)->Range(10, 1'000);
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+//++++++++++++++++++++Big_uint++++++++++++++++++++++++++++++++++++
+// state.range(0) is the size in decimal digits, so Big_int and Big_uint hold equal values.
+
+void BM_add_big_int(benchmark::State& state)
+{
+	std::mt19937 gen(3);
+	Big_int a = random_big_int(state.range(0), gen);
+	Big_int b = random_big_int(state.range(0), gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a + b);
+	}
+}
+BENCHMARK(BM_add_big_int)->RangeMultiplier(10)->Range(1'000, 1'000'000);
+
+void BM_add_big_uint(benchmark::State& state)
+{
+	std::mt19937 gen(3);
+	Big_uint a(random_big_int(state.range(0), gen).to_string());
+	Big_uint b(random_big_int(state.range(0), gen).to_string());
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a + b);
+	}
+}
+BENCHMARK(BM_add_big_uint)->RangeMultiplier(10)->Range(1'000, 1'000'000);
+
+void BM_multiply_big_int(benchmark::State& state)
+{
+	std::mt19937 gen(3);
+	Big_int a = random_big_int(state.range(0), gen);
+	Big_int b = random_big_int(state.range(0), gen);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a * b);
+	}
+}
+BENCHMARK(BM_multiply_big_int)->RangeMultiplier(10)->Range(100, 100'000);
+
+void BM_multiply_big_uint(benchmark::State& state)
+{
+	std::mt19937 gen(3);
+	Big_uint a(random_big_int(state.range(0), gen).to_string());
+	Big_uint b(random_big_int(state.range(0), gen).to_string());
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a * b);
+	}
+}
+BENCHMARK(BM_multiply_big_uint)->RangeMultiplier(10)->Range(100, 100'000);
+
+void BM_to_string_big_uint(benchmark::State& state)
+{
+	std::mt19937 gen(3);
+	Big_uint a(random_big_int(state.range(0), gen).to_string());
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a.to_string());
+	}
+}
+BENCHMARK(BM_to_string_big_uint)->RangeMultiplier(10)->Range(100, 100'000);
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+BENCHMARK_MAIN();
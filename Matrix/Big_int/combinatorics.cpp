@@ -0,0 +1,157 @@
+#include "combinatorics.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+/// Primes not greater than n by the sieve of Eratosthenes over odd numbers.
+std::vector<unsigned long long> primes_up_to(unsigned long long n)
+{
+	std::vector<unsigned long long> ret;
+	if (n < 2) {
+		return ret;
+	}
+	ret.push_back(2);
+	// is_composite[i] is for the odd number 2 * i + 1.
+	std::vector<bool> is_composite(n / 2 + 1, false);
+	for (unsigned long long i = 1; 2 * i + 1 <= n; ++i) {
+		if (is_composite[i]) {
+			continue;
+		}
+		unsigned long long p = 2 * i + 1;
+		ret.push_back(p);
+		if (p <= n / p) {
+			for (unsigned long long j = p * p; j <= n; j += 2 * p) {
+				is_composite[j / 2] = true;
+			}
+		}
+	}
+	return ret;
+}
+
+/// Leaves of a product tree: factors multiplied into words below 2^63.
+class Word_product
+{
+public:
+	void multiply(unsigned long long factor)
+	{
+		if (_word > _MAX_WORD / factor) {
+			_words.emplace_back(static_cast<long long>(_word));
+			_word = 1;
+		}
+		_word *= factor;
+	}
+
+	[[nodiscard]] Big_int value()
+	{
+		if (_word != 1) {
+			_words.emplace_back(static_cast<long long>(_word));
+			_word = 1;
+		}
+		return product(std::move(_words));
+	}
+
+private:
+	static constexpr unsigned long long _MAX_WORD = std::numeric_limits<long long>::max();
+
+	std::vector<Big_int> _words;
+	unsigned long long _word = 1;
+};
+
+/// Product of factors[first, last), the factors are moved from.
+Big_int product_tree(std::vector<Big_int>& factors, std::size_t first, std::size_t last)
+{
+	if (last - first == 1) {
+		return std::move(factors[first]);
+	}
+	std::size_t middle = first + (last - first) / 2;
+	return product_tree(factors, first, middle) * product_tree(factors, middle, last);
+}
+
+/// n! for primes containing all primes not greater than n.
+Big_int swing_factorial(unsigned long long n, const std::vector<unsigned long long>& primes)
+{
+	// 20! is the largest factorial below 2^63.
+	if (n <= 20) {
+		long long ret = 1;
+		for (unsigned long long i = 2; i <= n; ++i) {
+			ret *= static_cast<long long>(i);
+		}
+		return ret;
+	}
+	Big_int ret = square(swing_factorial(n / 2, primes));
+
+	// The exponent of p in n! / (n / 2)!^2 is the sum of floor(n / p^i) mod 2.
+	Word_product swing;
+	for (auto p = primes.begin(); p != primes.end() and *p <= n; ++p) {
+		for (unsigned long long quotient = n / *p; quotient != 0; quotient /= *p) {
+			if (quotient & 1) {
+				swing.multiply(*p);
+			}
+		}
+	}
+	return ret * swing.value();
+}
+
+/// Binomials with k up to this are computed by k word multiplications and divisions,
+/// without sieving up to n.
+constexpr unsigned long long MULTIPLICATIVE_BINOMIAL_LIMIT = 64;
+}
+
+Big_int product(std::vector<Big_int> factors)
+{
+	if (factors.empty()) {
+		return 1;
+	}
+	return product_tree(factors, 0, factors.size());
+}
+
+Big_int factorial(unsigned long long n)
+{
+	return swing_factorial(n, primes_up_to(n));
+}
+
+Big_int binomial(unsigned long long n, unsigned long long k)
+{
+	if (k > n) {
+		return 0;
+	}
+	k = std::min(k, n - k);
+	if (k <= MULTIPLICATIVE_BINOMIAL_LIMIT) {
+		// C(n - k + i, i) == C(n - k + i - 1, i - 1) * (n - k + i) / i exactly.
+		Big_int ret = 1;
+		for (unsigned long long i = 1; i <= k; ++i) {
+			ret *= static_cast<long long>(n - k + i);
+			ret.divmod_word(static_cast<Big_int::word_type>(i));
+		}
+		return ret;
+	}
+
+	Word_product ret;
+	for (unsigned long long p : primes_up_to(n)) {
+		// floor(n / p^i) - floor(k / p^i) - floor((n - k) / p^i) is 1
+		// if there is a borrow from digit i and 0 otherwise.
+		unsigned long long lhs = n;
+		unsigned long long rhs = k;
+		unsigned long long difference = n - k;
+		while (lhs >= p) {
+			lhs /= p;
+			rhs /= p;
+			difference /= p;
+			if (lhs != rhs + difference) {
+				ret.multiply(p);
+			}
+		}
+	}
+	return ret.value();
+}
+
+Big_int primorial(unsigned long long n)
+{
+	Word_product ret;
+	for (unsigned long long p : primes_up_to(n)) {
+		ret.multiply(p);
+	}
+	return ret.value();
+}
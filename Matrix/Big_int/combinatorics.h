@@ -0,0 +1,28 @@
+#ifndef COMBINATORICS_H
+#define COMBINATORICS_H
+
+#include <vector>
+#include "Big_int.h"
+
+// Products of many small factors are computed by balanced product trees:
+// factors are packed into machine words, then multiplied pairwise, so every
+// multiplication has operands of similar size and reaches Karatsuba, Toom-3
+// and the NTT instead of the schoolbook product of a huge and a tiny number.
+
+/// Return the product of factors by a balanced product tree, 1 for no factors.
+[[nodiscard]] Big_int product(std::vector<Big_int> factors);
+
+/// Return n! by the prime-swing algorithm: n! == (n / 2)!^2 * swing(n),
+/// where the swing number n! / (n / 2)!^2 is a product of prime powers.
+[[nodiscard]] Big_int factorial(unsigned long long n);
+
+/// Return n! / (k! * (n - k)!), 0 if k > n.
+/// The exponent of every prime p <= n is the number of borrows when
+/// subtracting k from n in base p (Kummer), so no division is needed.
+/// Small min(k, n - k) skips the sieve by exact word divisions. n must be below 2^63.
+[[nodiscard]] Big_int binomial(unsigned long long n, unsigned long long k);
+
+/// Return the product of all primes not greater than n.
+[[nodiscard]] Big_int primorial(unsigned long long n);
+
+#endif
@@ -0,0 +1,214 @@
+#include "modular.h"
+
+#include <algorithm>
+
+void Modular_context::_reduce(container_type& _data) const
+{
+	// q = floor(floor(_data / B^(n - 1)) * _reciprocal / B^(n + 1)) is at most
+	// 2 less than floor(_data / _modulus) (1 more if the product is truncated),
+	// so at most three subtractions remain.
+	size_type n = _modulus._data.size();
+	container_type quotient = Big_int::_slice(_data, n - 1, _data.size());
+	if (n >= _TRUNCATED_LIMIT) {
+		quotient = Big_int::_multiply_data(quotient, _reciprocal);
+		Big_int::_shift_right_limbs(quotient, n + 1);
+		Big_int::_subtract(_data, Big_int::_multiply_data(quotient, _modulus._data));
+	}
+	else {
+		// The remainder is below 4 * _modulus < B^(n + 1), so only the low limbs are needed.
+		quotient = _multiply_high(quotient, _reciprocal, n + 1);
+		container_type product = _multiply_low(quotient, _modulus._data, n + 1);
+		if (_data.size() > n + 1) {
+			_data.resize(n + 1);
+			Big_int::_delete_leading_zeros(_data);
+		}
+		if (Big_int::_veccmp(_data, product) == -1) {
+			_data.resize(n + 2, 0);
+			_data[n + 1] = 1;
+		}
+		Big_int::_subtract(_data, product);
+	}
+	while (Big_int::_veccmp(_data, _modulus._data) != -1) {
+		Big_int::_subtract(_data, _modulus._data);
+	}
+}
+
+Modular_context::container_type
+Modular_context::_multiply_high(const container_type& _lhs_data,
+								const container_type& _rhs_data,
+								size_type _shift)
+{
+	size_type first = _shift >= 2 ? _shift - 2 : 0;
+	container_type result(_lhs_data.size() + _rhs_data.size(), 0);
+	for (size_type i = 0; i < _lhs_data.size(); ++i) {
+		size_type j = std::min(first > i ? first - i : 0, _rhs_data.size());
+		result[i + _rhs_data.size()] =
+			Big_int::_addmul_1(result.data() + i + j, _rhs_data.data() + j, _rhs_data.size() - j, _lhs_data[i]);
+	}
+	Big_int::_shift_right_limbs(result, _shift);
+	Big_int::_delete_leading_zeros(result);
+	return result;
+}
+
+Modular_context::container_type
+Modular_context::_multiply_low(	const container_type& _lhs_data,
+								const container_type& _rhs_data,
+								size_type _limbs)
+{
+	container_type result(_limbs, 0);
+	for (size_type i = 0; i < _lhs_data.size() and i < _limbs; ++i) {
+		size_type size = std::min(_rhs_data.size(), _limbs - i);
+		Big_int::base_type carry = Big_int::_addmul_1(result.data() + i, _rhs_data.data(), size, _lhs_data[i]);
+		if (i + size < _limbs) {
+			result[i + size] = carry;
+		}
+	}
+	Big_int::_delete_leading_zeros(result);
+	return result;
+}
+
+std::vector<bool> Modular_context::_to_bits(const Big_int& _number)
+{
+	constexpr Big_int::base_type CHUNK_BITS = 30;
+	container_type data = _number._data;
+	std::vector<bool> ret;
+	while (!data.empty()) {
+		Big_int::base_type chunk = Big_int::_divide_by_word(data, Big_int::base_type(1) << CHUNK_BITS);
+		for (Big_int::base_type i = 0; i < CHUNK_BITS; ++i) {
+			ret.push_back((chunk >> i) & 1);
+		}
+	}
+	while (!ret.empty() and !ret.back()) {
+		ret.pop_back();
+	}
+	return ret;
+}
+
+Modular_context::size_type Modular_context::_window_size(size_type _bit_count)
+{
+	if (_bit_count > 768) {
+		return 6;
+	}
+	else if (_bit_count > 240) {
+		return 5;
+	}
+	else if (_bit_count > 80) {
+		return 4;
+	}
+	else if (_bit_count > 24) {
+		return 3;
+	}
+	else if (_bit_count > 6) {
+		return 2;
+	}
+	return 1;
+}
+
+Modular_context::Modular_context(Big_int modulus)
+	: _modulus(std::move(modulus))
+{
+	if (_modulus <= 0) {
+		throw "Modulus must be positive";
+	}
+	container_type power(2 * _modulus._data.size() + 1, 0);
+	power.back() = 1;
+	_reciprocal = Big_int::_divmod_data(power, _modulus._data).first;
+}
+
+const Big_int& Modular_context::modulus() const
+{
+	return _modulus;
+}
+
+Big_int Modular_context::reduce(Big_int number) const
+{
+	if (number._sign or number._data.size() > 2 * _modulus._data.size()) {
+		number %= _modulus;
+		if (number._sign) {
+			number += _modulus;
+		}
+	}
+	else {
+		_reduce(number._data);
+	}
+	return number;
+}
+
+Big_int Modular_context::multiply(const Big_int& lhs, const Big_int& rhs) const
+{
+	return reduce(lhs * rhs);
+}
+
+Big_int Modular_context::square(const Big_int& number) const
+{
+	return reduce(::square(number));
+}
+
+Big_int Modular_context::inverse(const Big_int& number) const
+{
+	auto [divisor, x, y] = xgcd(number, _modulus);
+	if (divisor != 1) {
+		throw "Number is not invertible";
+	}
+	return reduce(std::move(x));
+}
+
+Big_int Modular_context::pow(const Big_int& base, const Big_int& exponent) const
+{
+	if (exponent < 0) {
+		throw "Negative exponent";
+	}
+	std::vector<bool> bits = _to_bits(exponent);
+	if (bits.empty()) {
+		return reduce(1);
+	}
+
+	// Odd powers base^1, base^3, ..., base^(2^window - 1)
+	size_type window = _window_size(bits.size());
+	std::vector<Big_int> odd_powers(size_type(1) << (window - 1));
+	odd_powers[0] = reduce(base);
+	if (odd_powers.size() > 1) {
+		Big_int base_square = square(odd_powers[0]);
+		for (size_type i = 1; i < odd_powers.size(); ++i) {
+			odd_powers[i] = multiply(odd_powers[i - 1], base_square);
+		}
+	}
+
+	// Left to right, every window [low, high] of bits starts and ends with 1.
+	Big_int ret;
+	bool is_first_window = true;
+	for (size_type i = bits.size(); i != 0; ) {
+		size_type high = i - 1;
+		if (!bits[high]) {
+			ret = square(ret);
+			--i;
+			continue;
+		}
+		size_type low = high + 1 > window ? high + 1 - window : 0;
+		while (!bits[low]) {
+			++low;
+		}
+		size_type value = 0;
+		for (size_type j = high + 1; j != low; --j) {
+			value = 2 * value + bits[j - 1];
+		}
+
+		if (is_first_window) {
+			ret = odd_powers[value / 2];
+			is_first_window = false;
+		}
+		else {
+			for (size_type j = low; j <= high; ++j) {
+				ret = square(ret);
+			}
+			ret = multiply(ret, odd_powers[value / 2]);
+		}
+		i = low;
+	}
+	return ret;
+}
+
+Big_int pow_mod(const Big_int& base, const Big_int& exponent, const Big_int& modulus)
+{
+	return Modular_context(modulus).pow(base, exponent);
+}
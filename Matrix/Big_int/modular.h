@@ -0,0 +1,67 @@
+#ifndef MODULAR_H
+#define MODULAR_H
+
+#include <vector>
+#include "Big_int.h"
+
+/// Arithmetic modulo a fixed positive modulus by Barrett reduction.
+/// The constructor precomputes floor(B^(2n) / modulus) for the n-limb modulus,
+/// then every reduction of a product of reduced values costs two multiplications
+/// and no long division. Montgomery reduction is not used because it needs
+/// a modulus coprime to the decimal base of Big_int.
+class Modular_context
+{
+public:
+	/// Throw if modulus is not positive.
+	explicit Modular_context(Big_int modulus);
+
+	[[nodiscard]] const Big_int& modulus() const;
+
+	/// Return number mod modulus() in [0, modulus()).
+	/// Numbers in [0, modulus()^2) are reduced without division.
+	[[nodiscard]] Big_int reduce(Big_int number) const;
+
+	[[nodiscard]] Big_int multiply(const Big_int& lhs, const Big_int& rhs) const;
+	[[nodiscard]] Big_int square(const Big_int& number) const;
+
+	/// Return x in [0, modulus()) with number * x == 1 (mod modulus()).
+	/// Throw if gcd(number, modulus()) != 1.
+	[[nodiscard]] Big_int inverse(const Big_int& number) const;
+
+	/// Return base^exponent mod modulus() by sliding-window exponentiation.
+	/// Throw if exponent is negative.
+	[[nodiscard]] Big_int pow(const Big_int& base, const Big_int& exponent) const;
+
+private:
+	using container_type = Big_int::container_type;
+	using size_type = Big_int::size_type;
+
+	Big_int _modulus;
+	container_type _reciprocal;	// floor(_BASE^(2 * _modulus.size()) / _modulus)
+
+	/// Barrett reduction of 0 <= _data < _BASE^(2 * _modulus.size()).
+	void _reduce(container_type& _data) const;
+
+	/// Moduli shorter than this (in limbs) are reduced by the truncated schoolbook
+	/// products below, longer ones by the full products of Big_int.
+	static constexpr size_type _TRUNCATED_LIMIT = 160;
+
+	/// floor(_lhs_data * _rhs_data / _BASE^_shift) without the partial products
+	/// below _BASE^(_shift - 2). The result is at most 1 less than the exact one.
+	static container_type _multiply_high(const container_type& _lhs_data, const container_type& _rhs_data, size_type _shift);
+
+	/// _lhs_data * _rhs_data mod _BASE^_limbs.
+	static container_type _multiply_low(const container_type& _lhs_data, const container_type& _rhs_data, size_type _limbs);
+
+	/// Bits of the non-negative _number, least significant first.
+	static std::vector<bool> _to_bits(const Big_int& _number);
+
+	/// Window size for an exponent of _bit_count bits.
+	static size_type _window_size(size_type _bit_count);
+};
+
+/// Return base^exponent mod modulus in [0, modulus).
+/// Use Modular_context to reuse the precomputation for the same modulus.
+[[nodiscard]] Big_int pow_mod(const Big_int& base, const Big_int& exponent, const Big_int& modulus);
+
+#endif
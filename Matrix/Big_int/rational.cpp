@@ -1,4 +1,5 @@
 #include "rational.h"
+#include "Big_int_expression.h"
 
 void Rational::_rounding(std::string& str)
 {
@@ -68,14 +69,14 @@ Rational::Rational(int numerator, int denominator)
 	_simplify();
 }
 
-Rational::Rational(const value_type& numerator, const value_type& denominator)
-	: _numerator(numerator)
-	, _denominator(denominator)
+Rational::Rational(value_type numerator, value_type denominator)
+	: _numerator(std::move(numerator))
+	, _denominator(std::move(denominator))
 {
-	if (!denominator) {
+	if (!_denominator) {
 		throw "Denominator cannot be zero";
 	}
-	else if (denominator < 0) {
+	else if (_denominator < 0) {
 		_numerator.negate();
 		_denominator.negate();
 	}
@@ -88,7 +89,7 @@ Rational& Rational::operator+=(const Rational& rhs)
 		_numerator += rhs._numerator;
 	}
 	else {
-		_numerator = rhs._denominator * _numerator + _denominator * rhs._numerator;
+		_numerator = lazy(rhs._denominator) * _numerator + lazy(_denominator) * rhs._numerator;
 		_denominator *= rhs._denominator;
 	}
 	_simplify();
@@ -101,7 +102,7 @@ Rational& Rational::operator-=(const Rational& rhs)
 		_numerator -= rhs._numerator;
 	}
 	else {
-		_numerator = rhs._denominator * _numerator - _denominator * rhs._numerator;
+		_numerator = lazy(rhs._denominator) * _numerator - lazy(_denominator) * rhs._numerator;
 		_denominator *= rhs._denominator;
 	}
 	_simplify();
@@ -128,37 +129,53 @@ Rational& Rational::operator/=(const Rational& rhs)
 	return *this;
 }
 
-Rational Rational::operator+() const
+Rational Rational::operator+() const&
 {
 	return *this;
 }
 
-Rational Rational::operator-() const
+Rational Rational::operator+() &&
+{
+	return std::move(*this);
+}
+
+Rational Rational::operator-() const&
+{
+	Rational ret(*this);
+	ret._numerator.negate();
+	return ret;
+}
+
+Rational Rational::operator-() &&
 {
-	return Rational(-_numerator, _denominator);
+	_numerator.negate();
+	return std::move(*this);
 }
 
+// gcd(n + d, d) == gcd(n, d), so the result needs no simplification.
 Rational& Rational::operator++()
 {
-	return *this += 1;
+	_numerator += _denominator;
+	return *this;
 }
 
 Rational Rational::operator++(int)
 {
 	Rational ret(*this);
-	*this += 1;
+	++*this;
 	return ret;
 }
 
 Rational& Rational::operator--()
 {
-	return *this -= 1;
+	_numerator -= _denominator;
+	return *this;
 }
 
 Rational Rational::operator--(int)
 {
 	Rational ret(*this);
-	*this -= 1;
+	--*this;
 	return ret;
 }
 
@@ -194,12 +211,11 @@ std::string Rational::to_string() const
 std::string Rational::as_decimal(size_t precision) const
 {
 	std::string ret;
-	value_type integer_part = _numerator / _denominator;
+	auto [integer_part, float_part] = divmod(_numerator, _denominator);
 	if (!integer_part and _sign()) {
 		ret = '-';
 	}
 
-	value_type float_part = _numerator;
 	if (_sign()) {
 		float_part.negate();
 	}
@@ -207,12 +223,14 @@ std::string Rational::as_decimal(size_t precision) const
 	if (precision) {
 		ret += (integer_part).to_string() + '.';
 
-		for (size_t i = 0; (float_part %= _denominator) != 0 and i < precision; ++i) {
-			float_part *= 10;
-			ret += (float_part / _denominator).to_string();
+		for (size_t i = 0; float_part != 0 and i < precision; ++i) {
+			float_part.mul_word(10);
+			auto [digit, remainder] = divmod(float_part, _denominator);
+			ret += digit.to_string();
+			float_part = std::move(remainder);
 		}
 
-		float_part *= 10;
+		float_part.mul_word(10);
 		int rounding = static_cast<int>(float_part / _denominator);
 		if (rounding >= 5) {
 			_rounding(ret);
@@ -227,8 +245,7 @@ std::string Rational::as_decimal(size_t precision) const
 		}
 	}
 	else {
-		float_part %= _denominator;
-		float_part *= 10;
+		float_part.mul_word(10);
 		if (float_part / _denominator >= 5) {
 			ret += (integer_part + (_sign() and integer_part ? -1 : 1)).to_string();
 		}
@@ -249,35 +266,140 @@ Rational::value_type Rational::denominator() const
 	return _denominator;
 }
 
+std::size_t Rational::hash() const noexcept
+{
+	std::size_t ret = _numerator.hash();
+	return ret ^ (_denominator.hash() + 0x9e37'79b9'7f4a'7c15 + (ret << 6) + (ret >> 2));
+}
+
 Rational::operator double() const
 {
 	return std::stod(as_decimal(std::numeric_limits<double>::digits10));
 }
 
-Rational operator+(const Rational& lhs, const Rational& rhs)
+Rational operator+(Rational lhs, const Rational& rhs)
 {
-	Rational ret(lhs);
-	ret += rhs;
-	return ret;
+	lhs += rhs;
+	return lhs;
 }
 
-Rational operator-(const Rational& lhs, const Rational& rhs)
+Rational operator-(Rational lhs, const Rational& rhs)
 {
-	Rational ret(lhs);
-	ret -= rhs;
-	return ret;
+	lhs -= rhs;
+	return lhs;
 }
 
-Rational operator*(const Rational& lhs, const Rational& rhs)
+Rational operator*(Rational lhs, const Rational& rhs)
 {
-	Rational ret(lhs);
-	ret *= rhs;
-	return ret;
+	lhs *= rhs;
+	return lhs;
 }
 
-Rational operator/(const Rational& lhs, const Rational& rhs)
+Rational operator/(Rational lhs, const Rational& rhs)
 {
-	Rational ret(lhs);
-	ret /= rhs;
-	return ret;
+	lhs /= rhs;
+	return lhs;
+}
+
+//++++++++++++++++++++Rational_accumulator++++++++++++++++++++++++
+std::size_t Rational_accumulator::reduce_threshold = 64;
+
+Rational_accumulator::Rational_accumulator(const Rational& value)
+	: _numerator(value._numerator)
+	, _denominator(value._denominator)
+	, _reduced_digits(_denominator.chars_size()) {}
+
+Rational_accumulator& Rational_accumulator::operator+=(const Rational& rhs)
+{
+	if (_denominator == rhs._denominator) {
+		_numerator += rhs._numerator;
+	}
+	else {
+		_numerator = lazy(rhs._denominator) * _numerator + lazy(_denominator) * rhs._numerator;
+		_denominator *= rhs._denominator;
+	}
+	_reduce_if_large();
+	return *this;
+}
+
+Rational_accumulator& Rational_accumulator::operator-=(const Rational& rhs)
+{
+	if (_denominator == rhs._denominator) {
+		_numerator -= rhs._numerator;
+	}
+	else {
+		_numerator = lazy(rhs._denominator) * _numerator - lazy(_denominator) * rhs._numerator;
+		_denominator *= rhs._denominator;
+	}
+	_reduce_if_large();
+	return *this;
+}
+
+Rational_accumulator& Rational_accumulator::operator*=(const Rational& rhs)
+{
+	_numerator *= rhs._numerator;
+	_denominator *= rhs._denominator;
+	_reduce_if_large();
+	return *this;
+}
+
+Rational_accumulator& Rational_accumulator::operator/=(const Rational& rhs)
+{
+	if (!rhs._numerator) {
+		throw "Division by zero";
+	}
+	_numerator *= rhs._denominator;
+	_denominator *= rhs._numerator;
+	if (_denominator < 0) {
+		_numerator.negate();
+		_denominator.negate();
+	}
+	_reduce_if_large();
+	return *this;
+}
+
+bool Rational_accumulator::operator==(const Rational_accumulator& rhs) const
+{
+	return (*this <=> rhs) == 0;
+}
+
+std::strong_ordering Rational_accumulator::operator<=>(const Rational_accumulator& rhs) const
+{
+	std::weak_ordering cmp = _denominator == rhs._denominator ? _numerator <=> rhs._numerator
+		: _numerator * rhs._denominator <=> rhs._numerator * _denominator;
+	if (cmp < 0) {
+		return std::strong_ordering::less;
+	}
+	else if (cmp > 0) {
+		return std::strong_ordering::greater;
+	}
+	else {
+		return std::strong_ordering::equal;
+	}
+}
+
+Rational Rational_accumulator::value() const
+{
+	return Rational(_numerator, _denominator);
+}
+
+std::string Rational_accumulator::to_string() const
+{
+	return value().to_string();
+}
+
+void Rational_accumulator::reduce()
+{
+	Rational reduced(std::move(_numerator), std::move(_denominator));
+	_numerator = std::move(reduced._numerator);
+	_denominator = std::move(reduced._denominator);
+	_reduced_digits = _denominator.chars_size();
+}
+
+void Rational_accumulator::_reduce_if_large()
+{
+	std::size_t digits = _denominator.chars_size();
+	if (digits > reduce_threshold and digits > 2 * _reduced_digits) {
+		reduce();
+	}
 }
@@ -3,27 +3,38 @@
 
 #include <iostream>
 #include <compare>
+#include <cstddef>
+#include <functional>
 #include <numeric>
+#include <span>
 #include <string>
 #include "Big_int.h"
 
 class Rational
 {
+	friend class Rational_accumulator;
+	friend std::size_t serialized_size(const Rational& value);
+	friend std::size_t serialize(const Rational& value, std::span<std::byte> out);
+	friend std::size_t deserialize(std::span<const std::byte> in, Rational& value);
 public:
 	using value_type = Big_int;
 
 	Rational(int numerator = 0, int denominator = 1);
-	Rational(const value_type& numerator, const value_type& denominator = 1);
+	Rational(value_type numerator, value_type denominator = 1);
 	Rational(const Rational&) = default;
+	Rational(Rational&&) noexcept = default;
 	Rational& operator=(const Rational&) = default;
+	Rational& operator=(Rational&&) = default;
 
 	Rational& operator+=(const Rational& rhs);
 	Rational& operator-=(const Rational& rhs);
 	Rational& operator*=(const Rational& rhs);
 	Rational& operator/=(const Rational& rhs);
 
-	[[nodiscard]] Rational operator+() const;
-	[[nodiscard]] Rational operator-() const;
+	[[nodiscard]] Rational operator+() const&;
+	[[nodiscard]] Rational operator+() &&;
+	[[nodiscard]] Rational operator-() const&;
+	[[nodiscard]] Rational operator-() &&;
 
 	Rational& operator++();
 	Rational operator++(int);
@@ -37,6 +48,8 @@ public:
 	[[nodiscard]] std::string as_decimal(size_t precision = 0) const;
 	[[nodiscard]] value_type numerator() const;
 	[[nodiscard]] value_type denominator() const;
+	/// Combined hash of the numerator and the denominator, which are kept in lowest terms.
+	[[nodiscard]] std::size_t hash() const noexcept;
 
 	explicit operator double() const;
 
@@ -51,9 +64,58 @@ private:
 	void _simplify();
 };
 
-Rational operator+(const Rational& lhs, const Rational& rhs);
-Rational operator-(const Rational& lhs, const Rational& rhs);
-Rational operator*(const Rational& lhs, const Rational& rhs);
-Rational operator/(const Rational& lhs, const Rational& rhs);
+template <>
+struct std::hash<Rational>
+{
+	std::size_t operator()(const Rational& number) const noexcept
+	{
+		return number.hash();
+	}
+};
+
+/// Rational for long sequences of operations, kept as an unreduced fraction.
+/// Every operation of Rational divides by a gcd of the full-size numerator
+/// and denominator; here an operation costs only multiplications, and the
+/// gcd is taken by value(), to_string(), reduce(), and when the denominator
+/// has doubled in digits since the last reduction, so the gcds of growing
+/// operands are amortized. Comparisons cross-multiply without reducing.
+class Rational_accumulator
+{
+public:
+	using value_type = Rational::value_type;
+
+	Rational_accumulator(const Rational& value = Rational());
+
+	Rational_accumulator& operator+=(const Rational& rhs);
+	Rational_accumulator& operator-=(const Rational& rhs);
+	Rational_accumulator& operator*=(const Rational& rhs);
+	Rational_accumulator& operator/=(const Rational& rhs);
+
+	bool operator==(const Rational_accumulator& rhs) const;
+	std::strong_ordering operator<=>(const Rational_accumulator& rhs) const;
+
+	/// Return the value in lowest terms, without changing *this.
+	[[nodiscard]] Rational value() const;
+	[[nodiscard]] std::string to_string() const;
+	/// Divide the numerator and the denominator by their gcd.
+	void reduce();
+
+	/// Denominators of fewer decimal digits are never reduced automatically.
+	static std::size_t reduce_threshold;
+
+private:
+	value_type _numerator;
+	value_type _denominator;	// positive, not necessarily coprime with _numerator
+	/// Digits of _denominator after the last reduction.
+	std::size_t _reduced_digits;
+
+	/// Reduce if _denominator has grown past reduce_threshold and 2 * _reduced_digits.
+	void _reduce_if_large();
+};
+
+Rational operator+(Rational lhs, const Rational& rhs);
+Rational operator-(Rational lhs, const Rational& rhs);
+Rational operator*(Rational lhs, const Rational& rhs);
+Rational operator/(Rational lhs, const Rational& rhs);
 
 #endif
@@ -0,0 +1,352 @@
+#include "serialization.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(sizeof(Big_int::word_type) == 4, "Limbs are serialized as 4-byte words");
+
+namespace
+{
+/// Values below _BASE^2 are encoded as one varint.
+constexpr unsigned long long COMPACT_LIMIT = 1'000'000'000'000'000'000ULL;
+constexpr Big_int::word_type LIMB_LIMIT = 1'000'000'000;
+/// Limbs read from a stream at once, so that a corrupted limb count
+/// fails on the end of the stream before allocating all of its limbs.
+constexpr std::size_t STREAM_CHUNK = std::size_t(1) << 20;
+
+std::size_t varint_size(unsigned long long number)
+{
+	std::size_t ret = 1;
+	for (; number >= 0x80; number >>= 7) {
+		++ret;
+	}
+	return ret;
+}
+
+/// Return the number of bytes written.
+std::size_t write_varint(unsigned long long number, std::byte* out)
+{
+	std::size_t i = 0;
+	for (; number >= 0x80; number >>= 7) {
+		out[i++] = std::byte((number & 0x7F) | 0x80);
+	}
+	out[i++] = std::byte(number);
+	return i;
+}
+
+/// Return the number of bytes read.
+std::size_t read_varint(std::span<const std::byte> in, unsigned long long& number)
+{
+	number = 0;
+	for (std::size_t i = 0; i < in.size(); ++i) {
+		auto byte = std::to_integer<unsigned long long>(in[i]);
+		if (i == 9 and byte > 1) {
+			throw "Malformed serialized number";
+		}
+		number |= (byte & 0x7F) << (7 * i);
+		if (!(byte & 0x80)) {
+			// A padded varint would give a second encoding of the same value.
+			if (i > 0 and byte == 0) {
+				throw "Malformed serialized number";
+			}
+			return i + 1;
+		}
+	}
+	throw "Truncated serialized number";
+}
+
+/// Header byte and varint of one encoded number.
+struct Header
+{
+	bool is_negative;
+	bool is_compact;
+	unsigned long long value;	// the absolute value if is_compact, the limb count otherwise
+	std::size_t size;			// bytes of the header byte and of the varint
+};
+
+Header read_header(std::span<const std::byte> in)
+{
+	if (in.empty()) {
+		throw "Truncated serialized number";
+	}
+	auto first = std::to_integer<unsigned>(in[0]);
+	if ((first >> 2) != SERIALIZATION_VERSION) {
+		throw "Unsupported serialization version";
+	}
+	Header ret;
+	ret.is_negative = first & 2;
+	ret.is_compact = first & 1;
+	ret.size = 1 + read_varint(in.subspan(1), ret.value);
+	return ret;
+}
+
+/// Bytes of the number encoded at the beginning of in, without decoding its limbs.
+std::size_t encoded_size(std::span<const std::byte> in)
+{
+	Header header = read_header(in);
+	if (header.is_compact) {
+		return header.size;
+	}
+	if (header.value > (in.size() - header.size) / 4) {
+		throw "Truncated serialized number";
+	}
+	return header.size + 4 * header.value;
+}
+
+/// Append the bytes of one encoded number from is to buffer.
+void read_encoded(std::istream& is, std::vector<std::byte>& buffer)
+{
+	std::size_t first = buffer.size();
+	// The header byte, then the varint up to its byte without the continuation bit.
+	do {
+		int c = is.get();
+		if (c == std::istream::traits_type::eof()) {
+			throw "Truncated serialized number";
+		}
+		buffer.push_back(std::byte(c));
+	} while (buffer.size() - first == 1 or
+		((buffer.back() & std::byte(0x80)) != std::byte(0) and buffer.size() - first <= 10));
+
+	Header header = read_header(std::span<const std::byte>(buffer).subspan(first));
+	if (header.is_compact) {
+		return;
+	}
+	for (unsigned long long left = 4 * header.value; left != 0; ) {
+		std::size_t count = static_cast<std::size_t>(std::min<unsigned long long>(left, 4 * STREAM_CHUNK));
+		std::size_t size = buffer.size();
+		buffer.resize(size + count);
+		is.read(reinterpret_cast<char*>(buffer.data() + size), static_cast<std::streamsize>(count));
+		if (static_cast<std::size_t>(is.gcount()) != count) {
+			throw "Truncated serialized number";
+		}
+		left -= count;
+	}
+}
+
+void write_bytes(std::ostream& os, const std::vector<std::byte>& buffer)
+{
+	os.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+}
+}
+
+std::size_t serialized_size(const Big_int& value)
+{
+	if (value._data.size() <= 2) {
+		return 1 + varint_size(Big_int::_to_ull(value));
+	}
+	return 1 + varint_size(value._data.size()) + 4 * value._data.size();
+}
+
+std::size_t serialized_size(const Rational& value)
+{
+	return serialized_size(value._numerator) + serialized_size(value._denominator);
+}
+
+std::size_t serialize(const Big_int& value, std::span<std::byte> out)
+{
+	std::size_t size = serialized_size(value);
+	if (out.size() < size) {
+		throw "Output buffer is too short";
+	}
+	bool is_compact = value._data.size() <= 2;
+	out[0] = std::byte(SERIALIZATION_VERSION << 2 | value._sign << 1 | is_compact);
+	if (is_compact) {
+		write_varint(Big_int::_to_ull(value), out.data() + 1);
+		return size;
+	}
+
+	std::byte* limbs = out.data() + 1 + write_varint(value._data.size(), out.data() + 1);
+	if constexpr (std::endian::native == std::endian::little) {
+		std::memcpy(limbs, value._data.data(), 4 * value._data.size());
+	}
+	else {
+		for (Big_int::base_type limb : value._data) {
+			for (int i = 0; i < 4; ++i) {
+				*limbs++ = std::byte(limb >> (8 * i));
+			}
+		}
+	}
+	return size;
+}
+
+std::size_t serialize(const Rational& value, std::span<std::byte> out)
+{
+	if (out.size() < serialized_size(value)) {
+		throw "Output buffer is too short";
+	}
+	std::size_t size = serialize(value._numerator, out);
+	return size + serialize(value._denominator, out.subspan(size));
+}
+
+void serialize(const Big_int& value, std::vector<std::byte>& out)
+{
+	std::size_t size = out.size();
+	out.resize(size + serialized_size(value));
+	serialize(value, std::span<std::byte>(out).subspan(size));
+}
+
+void serialize(const Rational& value, std::vector<std::byte>& out)
+{
+	std::size_t size = out.size();
+	out.resize(size + serialized_size(value));
+	serialize(value, std::span<std::byte>(out).subspan(size));
+}
+
+void serialize(const Big_int& value, std::ostream& os)
+{
+	std::vector<std::byte> buffer;
+	serialize(value, buffer);
+	write_bytes(os, buffer);
+}
+
+void serialize(const Rational& value, std::ostream& os)
+{
+	std::vector<std::byte> buffer;
+	serialize(value, buffer);
+	write_bytes(os, buffer);
+}
+
+std::size_t deserialize(std::span<const std::byte> in, Big_int& value)
+{
+	Header header = read_header(in);
+	std::size_t size = header.size;
+	value._zeroing();
+	if (header.is_compact) {
+		if (header.value >= COMPACT_LIMIT) {
+			throw "Malformed serialized number";
+		}
+		Big_int::_add_word(value._data, header.value);
+	}
+	else {
+		if (header.value > (in.size() - size) / 4) {
+			throw "Truncated serialized number";
+		}
+		Big_int::size_type count = static_cast<Big_int::size_type>(header.value);
+		const std::byte* limbs = in.data() + size;
+		value._data.resize(count);
+		if constexpr (std::endian::native == std::endian::little) {
+			std::memcpy(value._data.data(), limbs, 4 * count);
+		}
+		else {
+			for (auto& limb : value._data) {
+				limb = 0;
+				for (int i = 0; i < 4; ++i) {
+					limb |= std::to_integer<Big_int::base_type>(*limbs++) << (8 * i);
+				}
+			}
+		}
+		size += 4 * count;
+		// Shorter numbers are compact, so the encoding of every value is unique.
+		bool is_valid = count > 2 and value._data.back() != 0 and
+			std::all_of(value._data.begin(), value._data.end(), [](Big_int::base_type limb) { return limb < LIMB_LIMIT; });
+		if (!is_valid) {
+			value._zeroing();
+			throw "Malformed serialized number";
+		}
+	}
+	if (header.is_negative) {
+		if (!value) {
+			throw "Malformed serialized number";
+		}
+		value._sign = true;
+	}
+	return size;
+}
+
+std::size_t deserialize(std::span<const std::byte> in, Rational& value)
+{
+	std::size_t size = deserialize(in, value._numerator);
+	size += deserialize(in.subspan(size), value._denominator);
+	if (value._denominator <= 0) {
+		value = Rational();
+		throw "Malformed serialized number";
+	}
+	return size;
+}
+
+void deserialize(std::istream& is, Big_int& value)
+{
+	std::vector<std::byte> buffer;
+	read_encoded(is, buffer);
+	deserialize(buffer, value);
+}
+
+void deserialize(std::istream& is, Rational& value)
+{
+	std::vector<std::byte> buffer;
+	read_encoded(is, buffer);
+	read_encoded(is, buffer);
+	deserialize(buffer, value);
+}
+
+Mapped_big_int_array::Mapped_big_int_array(const std::string& path)
+	: _data(nullptr)
+	, _size(0)
+	, _offsets(1, 0)
+{
+	int file = ::open(path.c_str(), O_RDONLY);
+	if (file == -1) {
+		throw "Cannot open file";
+	}
+	struct stat status;
+	if (::fstat(file, &status) == -1) {
+		::close(file);
+		throw "Cannot open file";
+	}
+	_size = static_cast<std::size_t>(status.st_size);
+	if (_size != 0) {
+		void* address = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (address == MAP_FAILED) {
+			::close(file);
+			throw "Cannot map file";
+		}
+		_data = static_cast<const std::byte*>(address);
+	}
+	::close(file);
+
+	try {
+		while (_offsets.back() < _size) {
+			std::size_t offset = _offsets.back();
+			_offsets.push_back(offset + encoded_size({ _data + offset, _size - offset }));
+		}
+	}
+	catch (...) {
+		if (_data) {
+			::munmap(const_cast<std::byte*>(_data), _size);
+		}
+		throw;
+	}
+}
+
+Mapped_big_int_array::~Mapped_big_int_array()
+{
+	if (_data) {
+		::munmap(const_cast<std::byte*>(_data), _size);
+	}
+}
+
+std::size_t Mapped_big_int_array::size() const
+{
+	return _offsets.size() - 1;
+}
+
+Big_int Mapped_big_int_array::operator[](std::size_t index) const
+{
+	Big_int ret;
+	deserialize(bytes(index), ret);
+	return ret;
+}
+
+std::span<const std::byte> Mapped_big_int_array::bytes(std::size_t index) const
+{
+	if (index >= size()) {
+		throw "Index out of range";
+	}
+	return { _data + _offsets[index], _offsets[index + 1] - _offsets[index] };
+}
@@ -0,0 +1,81 @@
+#ifndef SERIALIZATION_H
+#define SERIALIZATION_H
+
+#include <cstddef>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+#include "Big_int.h"
+#include "rational.h"
+
+// Binary encoding of Big_int, version SERIALIZATION_VERSION:
+//
+//     header byte    version << 2 | is_negative << 1 | is_compact
+//     compact        LEB128 varint of the absolute value, for values below 10^18
+//     otherwise      LEB128 varint of the limb count n, then n limbs in base 10^9
+//                    as 4-byte little-endian words, least significant first
+//
+// The limbs are stored as they are in memory, so neither direction converts
+// between bases. A Rational is its numerator followed by its denominator.
+// Decoding throws a string literal on a truncated or malformed input,
+// including limbs out of range, leading zero limbs and varints padded with
+// zero bytes, so that every value has exactly one encoding.
+
+inline constexpr unsigned char SERIALIZATION_VERSION = 1;
+
+/// Number of bytes written by serialize().
+[[nodiscard]] std::size_t serialized_size(const Big_int& value);
+[[nodiscard]] std::size_t serialized_size(const Rational& value);
+
+/// Write value to the beginning of out. Return the number of bytes written.
+/// Throw if out is shorter than serialized_size(value).
+std::size_t serialize(const Big_int& value, std::span<std::byte> out);
+std::size_t serialize(const Rational& value, std::span<std::byte> out);
+
+/// Append value to the end of out.
+void serialize(const Big_int& value, std::vector<std::byte>& out);
+void serialize(const Rational& value, std::vector<std::byte>& out);
+
+void serialize(const Big_int& value, std::ostream& os);
+void serialize(const Rational& value, std::ostream& os);
+
+/// Read value from the beginning of in. Return the number of bytes read.
+/// The denominator of a Rational must be positive and is trusted to be
+/// coprime with the numerator, as written by serialize().
+std::size_t deserialize(std::span<const std::byte> in, Big_int& value);
+std::size_t deserialize(std::span<const std::byte> in, Rational& value);
+
+/// Read exactly one encoded value from is.
+void deserialize(std::istream& is, Big_int& value);
+void deserialize(std::istream& is, Rational& value);
+
+/// Read-only array of the Big_int values of a file written back to back by serialize().
+/// The file is memory-mapped and only the headers are scanned on opening,
+/// so the limbs of a number are read from disk when it is accessed.
+class Mapped_big_int_array
+{
+public:
+	/// Throw if the file cannot be mapped or is not a sequence of encoded values.
+	explicit Mapped_big_int_array(const std::string& path);
+	~Mapped_big_int_array();
+
+	Mapped_big_int_array(const Mapped_big_int_array&) = delete;
+	Mapped_big_int_array& operator=(const Mapped_big_int_array&) = delete;
+
+	[[nodiscard]] std::size_t size() const;
+
+	/// Decode the number at index. Throw if index >= size().
+	[[nodiscard]] Big_int operator[](std::size_t index) const;
+
+	/// Encoded bytes of the number at index. Throw if index >= size().
+	[[nodiscard]] std::span<const std::byte> bytes(std::size_t index) const;
+
+private:
+	const std::byte* _data;
+	std::size_t _size;
+	/// _offsets[i] is the first byte of number i, _offsets.back() == _size.
+	std::vector<std::size_t> _offsets;
+};
+
+#endif
@@ -1,19 +1,71 @@
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <limits>
+#include <new>
 #include <random>
+#include <sstream>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "gtest/gtest.h"
 
 #include "../Big_int.h"
 #include "../Big_int.cpp"
+#include "../Big_int_expression.h"
+#include "../Big_uint.h"
+#include "../Fixed_int.h"
 #include "../rational.h"
 #include "../rational.cpp"
+#include "../modular.h"
+#include "../modular.cpp"
+#include "../combinatorics.h"
+#include "../combinatorics.cpp"
+#include "../serialization.h"
+#include "../serialization.cpp"
+#include "../../matrix.h"
+
+// Count heap allocations to check the inline storage of small numbers.
+// Atomic because parallel multiplication allocates on several threads.
+static std::atomic<std::size_t> allocation_count = 0;
+
+void* operator new(std::size_t size)
+{
+	++allocation_count;
+	if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
 
 // class Big_int
 
+Big_int random_big_int(size_t digits, std::mt19937& gen)
+{
+	std::uniform_int_distribution<int> dist('0', '9');
+	std::string str(digits, '0');
+	for (auto& c : str) {
+		c = static_cast<char>(dist(gen));
+	}
+	str.front() = '1' + dist(gen) % 9;
+	return Big_int(str);
+}
+
 TEST(BigintegerTest, from_int)
 {
 	std::vector<int> values =
@@ -115,6 +167,53 @@ TEST(BigintegerTest, assignment_return_value)
 	EXPECT_TRUE(b == 7);
 }
 
+TEST(BigintegerTest, move_ctor_and_assignment)
+{
+	Big_int large("-" + std::string(100, '7'));
+	Big_int a = large;
+
+	std::size_t count = allocation_count;
+	Big_int b(std::move(a));
+	EXPECT_EQ(large, b);
+	EXPECT_EQ(0, a);
+	a = std::move(b);
+	EXPECT_EQ(large, a);
+	EXPECT_EQ(0, b);
+	EXPECT_FALSE(b < 0);
+	EXPECT_EQ(count, allocation_count);
+}
+
+TEST(BigintegerTest, rvalue_operators)
+{
+	std::mt19937 gen(9);
+	for (int i = 0; i < 20; ++i) {
+		Big_int a = random_big_int(1 + gen() % 60, gen);
+		Big_int b = random_big_int(1 + gen() % 60, gen);
+		if (i % 2) {
+			a.negate();
+		}
+		if (i % 3) {
+			b.negate();
+		}
+		Big_int sum = a + b;
+		Big_int difference = a - b;
+		Big_int product = a * b;
+		EXPECT_EQ(sum, Big_int(a) + b);
+		EXPECT_EQ(sum, a + Big_int(b));
+		EXPECT_EQ(sum, Big_int(a) + Big_int(b));
+		EXPECT_EQ(difference, Big_int(a) - b);
+		EXPECT_EQ(difference, a - Big_int(b));
+		EXPECT_EQ(difference, Big_int(a) - Big_int(b));
+		EXPECT_EQ(product, Big_int(a) * b);
+		EXPECT_EQ(product, a * Big_int(b));
+		EXPECT_EQ(product, Big_int(a) * Big_int(b));
+		EXPECT_EQ(a / b, Big_int(a) / b);
+		EXPECT_EQ(a % b, Big_int(a) % b);
+		EXPECT_EQ(-a, -Big_int(a));
+		EXPECT_EQ(0, a - Big_int(a));
+	}
+}
+
 TEST(BigintegerTest, comparisons)
 {
 	Big_int a("1000000000000000000000000000000000000000000000000000000"
@@ -366,6 +465,44 @@ TEST(BigintegerTest, decrement)
 	EXPECT_EQ(41, post);
 }
 
+TEST(BigintegerTest, word_operations)
+{
+	Big_int a("999999999999999999");
+	EXPECT_EQ(Big_int("1000000000000000000"), ++a);
+	EXPECT_EQ(Big_int("999999999999999999"), --a);
+	EXPECT_EQ(-1, --Big_int(0));
+	EXPECT_EQ(0, ++Big_int(-1));
+
+	std::mt19937 gen(37);
+	const Big_int::word_type words[] = { 0, 1, 7, 999'999'999, 1'000'000'000, 4'294'967'295 };
+	for (int i = 0; i < 50; ++i) {
+		Big_int number = i < 6 ? Big_int(i - 3) : random_big_int(1 + gen() % 40, gen);
+		if (i % 2) {
+			number.negate();
+		}
+		for (Big_int::word_type word : words) {
+			Big_int expected_sum = number + Big_int(word);
+			Big_int expected_difference = number - Big_int(word);
+			Big_int expected_product = number * Big_int(word);
+			EXPECT_EQ(expected_sum, Big_int(number).add_word(word));
+			EXPECT_EQ(expected_difference, Big_int(number).sub_word(word));
+			EXPECT_EQ(expected_product, Big_int(number).mul_word(word));
+			if (word != 0) {
+				Big_int quotient = number;
+				long long remainder = quotient.divmod_word(word);
+				EXPECT_EQ(number / Big_int(word), quotient);
+				EXPECT_EQ(number % Big_int(word), remainder);
+			}
+		}
+		Big_int shifted = number;
+		shifted.shift_limbs(3);
+		EXPECT_EQ(number * Big_int("1000000000000000000000000000"), shifted);
+		shifted.shift_limbs(-5);
+		EXPECT_EQ(number / Big_int("1000000000000000000"), shifted);
+	}
+	EXPECT_THROW(Big_int(1).divmod_word(0), const char*);
+}
+
 TEST(BigintegerTest, add_long)
 {
 	Big_int a("10000000000000000000000000000000000000000000000000000000000000"
@@ -409,6 +546,13 @@ TEST(BigintegerTest, add_long_pow2)
 	EXPECT_EQ(a, c + b);
 }
 
+TEST(BigintegerTest, add_long_different_sizes)
+{
+	EXPECT_EQ(Big_int("1000000000000000000"), Big_int("999999999999999999") + 1);
+	EXPECT_EQ(Big_int("1000000000000000000"), 1 + Big_int("999999999999999999"));
+	EXPECT_EQ(Big_int("1000000000000000000000000001"), Big_int(1) + Big_int("1000000000000000000000000000"));
+}
+
 TEST(BigintegerTest, sub_long)
 {
 	Big_int a("10000000000000000000000000000000000000000000000000000000000000"
@@ -420,6 +564,12 @@ TEST(BigintegerTest, sub_long)
 	EXPECT_EQ(c, a - b);
 }
 
+TEST(BigintegerTest, sub_long_borrow_through_equal_limbs)
+{
+	EXPECT_EQ(Big_int("999999999999999999"), Big_int("1000000005000000000") - Big_int("5000000001"));
+	EXPECT_EQ(Big_int("-999999999999999999"), Big_int("999999999999999999") - Big_int("1999999999999999998"));
+}
+
 TEST(BigintegerTest, sub_long_pow2)
 {
 	Big_int a("36893488147419103232");
@@ -472,6 +622,135 @@ TEST(BigintegerTest, mul_long_pow2)
 	EXPECT_EQ(c, b * b);
 }
 
+TEST(BigintegerTest, mul_tiers_match_schoolbook)
+{
+	std::mt19937 gen(42);
+	const size_t karatsuba_threshold = Big_int::karatsuba_threshold;
+	const size_t toom3_threshold = Big_int::toom3_threshold;
+	const size_t ntt_threshold = Big_int::ntt_threshold;
+	Big_int::ntt_threshold = std::numeric_limits<size_t>::max();
+	const std::vector<std::pair<size_t, size_t>> sizes =
+	{
+		{ 100, 100 }, { 450, 470 }, { 900, 2'000 }, { 3'000, 3'001 }, { 5'000, 200 }, { 7'000, 6'500 }
+	};
+
+	for (auto [lhs_digits, rhs_digits] : sizes) {
+		Big_int a = random_big_int(lhs_digits, gen);
+		Big_int b = -random_big_int(rhs_digits, gen);
+
+		Big_int::karatsuba_threshold = std::numeric_limits<size_t>::max();
+		Big_int schoolbook = a * b;
+		Big_int::karatsuba_threshold = 2;
+		Big_int::toom3_threshold = std::numeric_limits<size_t>::max();
+		Big_int karatsuba = a * b;
+		Big_int::toom3_threshold = 3;
+		Big_int toom3 = a * b;
+		Big_int::karatsuba_threshold = karatsuba_threshold;
+		Big_int::toom3_threshold = toom3_threshold;
+
+		EXPECT_EQ(schoolbook.to_string(), karatsuba.to_string());
+		EXPECT_EQ(schoolbook.to_string(), toom3.to_string());
+		EXPECT_EQ(schoolbook.to_string(), (a * b).to_string());
+	}
+	Big_int::ntt_threshold = ntt_threshold;
+}
+
+TEST(BigintegerTest, mul_ntt_matches_toom3)
+{
+	std::mt19937 gen(7);
+	const size_t ntt_threshold = Big_int::ntt_threshold;
+	const std::vector<std::pair<size_t, size_t>> sizes =
+	{
+		{ 20, 20 }, { 1'000, 1'000 }, { 10'000, 300 }, { 30'000, 29'000 }, { 100'000, 100'000 }
+	};
+
+	for (auto [lhs_digits, rhs_digits] : sizes) {
+		Big_int a = random_big_int(lhs_digits, gen);
+		Big_int b = random_big_int(rhs_digits, gen);
+
+		Big_int::ntt_threshold = std::numeric_limits<size_t>::max();
+		Big_int toom3 = a * b;
+		Big_int::ntt_threshold = 1;
+		Big_int ntt = a * b;
+		Big_int::ntt_threshold = ntt_threshold;
+
+		EXPECT_EQ(toom3.to_string(), ntt.to_string());
+	}
+
+	// Every limb is _BASE - 1, so the convolution coefficients are maximal.
+	Big_int nines(std::string(200'000, '9'));
+	Big_int::ntt_threshold = 1;
+	Big_int ntt = nines * nines;
+	Big_int::ntt_threshold = ntt_threshold;
+	EXPECT_EQ(std::string(199'999, '9') + '8' + std::string(199'999, '0') + '1', ntt.to_string());
+}
+
+TEST(BigintegerTest, parallel_mul_matches_sequential)
+{
+	std::mt19937 gen(43);
+	const size_t thread_count = Big_int::thread_count;
+	const size_t parallel_threshold = Big_int::parallel_threshold;
+	const size_t ntt_threshold = Big_int::ntt_threshold;
+	const std::vector<std::pair<size_t, size_t>> sizes =
+	{
+		{ 3'000, 3'001 }, { 20'000, 900 }, { 9'000, 8'000 }, { 50'000, 50'000 }
+	};
+
+	for (size_t tested_ntt_threshold : { ntt_threshold, std::numeric_limits<size_t>::max() }) {
+		Big_int::ntt_threshold = tested_ntt_threshold;
+		for (auto [lhs_digits, rhs_digits] : sizes) {
+			Big_int a = random_big_int(lhs_digits, gen);
+			Big_int b = -random_big_int(rhs_digits, gen);
+
+			Big_int::thread_count = 1;
+			Big_int product = a * b;
+			Big_int square = a * a;
+			Big_int::thread_count = 4;
+			Big_int::parallel_threshold = 40;
+			EXPECT_EQ(product.to_string(), (a * b).to_string());
+			EXPECT_EQ(square.to_string(), (a * a).to_string());
+			Big_int::thread_count = thread_count;
+			Big_int::parallel_threshold = parallel_threshold;
+		}
+	}
+	Big_int::ntt_threshold = ntt_threshold;
+}
+
+TEST(BigintegerTest, square_matches_mul)
+{
+	std::mt19937 gen(11);
+	const size_t karatsuba_threshold = Big_int::karatsuba_threshold;
+	const size_t toom3_threshold = Big_int::toom3_threshold;
+	const size_t ntt_threshold = Big_int::ntt_threshold;
+	const std::vector<std::pair<size_t, size_t>> thresholds =
+	{
+		{ std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max() }, { 2, std::numeric_limits<size_t>::max() }, { 2, 3 }
+	};
+
+	for (size_t digits : { 1, 9, 10, 100, 1'000, 5'000 }) {
+		Big_int a = -random_big_int(digits, gen);
+		Big_int::ntt_threshold = std::numeric_limits<size_t>::max();
+		Big_int expected = a * Big_int(a);
+		for (auto [karatsuba, toom3] : thresholds) {
+			Big_int::karatsuba_threshold = karatsuba;
+			Big_int::toom3_threshold = toom3;
+			EXPECT_EQ(expected, square(a));
+		}
+		Big_int::karatsuba_threshold = karatsuba_threshold;
+		Big_int::toom3_threshold = toom3_threshold;
+		Big_int::ntt_threshold = 1;
+		EXPECT_EQ(expected, a * a);
+		Big_int::ntt_threshold = ntt_threshold;
+
+		a *= a;
+		EXPECT_EQ(expected, a);
+	}
+
+	Big_int nines(std::string(1'000, '9'));
+	EXPECT_EQ(std::string(999, '9') + '8' + std::string(999, '0') + '1', square(nines).to_string());
+	EXPECT_EQ(0, square(0));
+}
+
 TEST(BigintegerTest, div_0_long)
 {
 	Big_int a;
@@ -509,6 +788,398 @@ TEST(BigintegerTest, div_long_signed2)
 	EXPECT_EQ(c, a / b);
 }
 
+TEST(BigintegerTest, div_mod_long_random)
+{
+	std::mt19937 gen(3);
+	std::uniform_int_distribution<size_t> digits_dist(1, 300);
+	for (size_t i = 0; i < 2'000; ++i) {
+		size_t lhs_digits = digits_dist(gen);
+		size_t rhs_digits = std::uniform_int_distribution<size_t>(1, lhs_digits)(gen);
+		Big_int a = random_big_int(lhs_digits, gen);
+		Big_int b = random_big_int(rhs_digits, gen);
+		if (i % 2) {
+			// Runs of nines and zeros provoke the corrections of the quotient estimate.
+			std::string str = a.to_string();
+			std::replace_if(str.begin() + 1, str.end(), [](char c) { return c < '5'; }, '0');
+			std::replace_if(str.begin(), str.end(), [](char c) { return c >= '5'; }, '9');
+			a = Big_int(str);
+			b = Big_int("9" + std::string(rhs_digits - 1, '0'));
+		}
+
+		Big_int q = a / b;
+		Big_int r = a % b;
+		EXPECT_EQ(a, q * b + r);
+		EXPECT_TRUE(0 <= r and r < b);
+	}
+}
+
+TEST(BigintegerTest, div_newton_matches_schoolbook)
+{
+	std::mt19937 gen(11);
+	const size_t newton_division_threshold = Big_int::newton_division_threshold;
+	const std::vector<std::pair<size_t, size_t>> sizes =
+	{
+		{ 100, 50 }, { 200, 100 }, { 1'000, 300 }, { 3'000, 2'000 }, { 10'000, 900 }, { 20'000, 10'000 }
+	};
+
+	for (auto [lhs_digits, rhs_digits] : sizes) {
+		Big_int a = random_big_int(lhs_digits, gen);
+		Big_int b = random_big_int(rhs_digits, gen);
+		Big_int nines(std::string(lhs_digits, '9'));
+		Big_int power("1" + std::string(rhs_digits - 1, '0'));
+
+		Big_int::newton_division_threshold = std::numeric_limits<size_t>::max();
+		auto [q_schoolbook, r_schoolbook] = divmod(a, b);
+		auto [q_nines_schoolbook, r_nines_schoolbook] = divmod(nines, power);
+		Big_int::newton_division_threshold = 4;
+		auto [q_newton, r_newton] = divmod(a, b);
+		auto [q_nines_newton, r_nines_newton] = divmod(nines, power);
+		Big_int::newton_division_threshold = newton_division_threshold;
+
+		EXPECT_EQ(q_schoolbook, q_newton);
+		EXPECT_EQ(r_schoolbook, r_newton);
+		EXPECT_EQ(q_nines_schoolbook, q_nines_newton);
+		EXPECT_EQ(r_nines_schoolbook, r_nines_newton);
+	}
+}
+
+TEST(BigintegerTest, divmod)
+{
+	std::vector<std::pair<long long, long long>> values =
+	{
+		{ 0, 7 }, { 7, 7 }, { 6, 7 }, { 1'000'000'007, 13 }, { -1'000'000'007, 13 },
+		{ 1'000'000'007, -13 }, { -1'000'000'007, -13 }, { 123'456'789'123'456'789, 1'000'000'001 }
+	};
+	for (auto [lhs, rhs] : values) {
+		auto [quotient, remainder] = divmod(lhs, rhs);
+		EXPECT_EQ(lhs / rhs, quotient);
+		EXPECT_EQ(lhs % rhs, remainder);
+	}
+
+	Big_int a("-123456789123456789123456789123456789123456789");
+	Big_int b("987654321987654321");
+	auto [quotient, remainder] = divmod(a, b);
+	EXPECT_EQ(a / b, quotient);
+	EXPECT_EQ(a % b, remainder);
+	EXPECT_THROW(divmod(a, 0), const char*);
+}
+
+TEST(BigintegerTest, pow)
+{
+	EXPECT_EQ(1, pow(Big_int(0), 0));
+	EXPECT_EQ(0, pow(Big_int(0), 5));
+	EXPECT_EQ(-8, pow(Big_int(-2), 3));
+	EXPECT_EQ(16, pow(Big_int(-2), 4));
+	EXPECT_EQ("1267650600228229401496703205376", pow(Big_int(2), 100).to_string());
+	EXPECT_EQ("28679718602997181072337614380936720482949", pow(Big_int(123'456'789), 5).to_string());
+}
+
+/// base^exponent % modulus by binary exponentiation with operator%.
+Big_int naive_pow_mod(Big_int base, Big_int exponent, const Big_int& modulus)
+{
+	Big_int ret = 1;
+	base %= modulus;
+	while (exponent) {
+		auto [half, bit] = divmod(exponent, 2);
+		if (bit) {
+			ret = ret * base % modulus;
+		}
+		base = base * base % modulus;
+		exponent = half;
+	}
+	return ret % modulus;
+}
+
+TEST(BigintegerTest, pow_mod)
+{
+	EXPECT_EQ(719'476'260, pow_mod(2, Big_int("1000000000000000000"), 1'000'000'007));
+	EXPECT_EQ(Big_int("80065568820118128874459519738933122578"),
+		pow_mod(3, Big_int("12345678901234567890"), Big_int("170141183460469231731687303715884105727")));
+	EXPECT_EQ(593, pow_mod(-7, 13, 1'000));
+	EXPECT_EQ(1, pow_mod(5, 0, 7));
+	EXPECT_EQ(0, pow_mod(5, 3, 1));
+	EXPECT_THROW(pow_mod(5, -1, 7), const char*);
+	EXPECT_THROW(pow_mod(5, 3, 0), const char*);
+
+	std::mt19937 gen(13);
+	for (size_t digits : { 5, 20, 100, 617 }) {
+		Big_int modulus = random_big_int(digits, gen);
+		Modular_context context(modulus);
+		for (int i = 0; i < 3; ++i) {
+			Big_int base = random_big_int(digits + 3, gen);
+			Big_int exponent = random_big_int(1 + gen() % 60, gen);
+			EXPECT_EQ(naive_pow_mod(base, exponent, modulus), context.pow(base, exponent));
+		}
+	}
+}
+
+TEST(BigintegerTest, modular_context_reduce)
+{
+	std::mt19937 gen(17);
+	for (size_t digits : { 1, 9, 10, 50, 300, 1'500 }) {
+		Big_int modulus = random_big_int(digits, gen);
+		Modular_context context(modulus);
+		EXPECT_EQ(modulus, context.modulus());
+		for (size_t number_digits : { digits / 2 + 1, digits, 2 * digits, 2 * digits + 20 }) {
+			Big_int number = random_big_int(number_digits, gen);
+			Big_int expected = number % modulus;
+			EXPECT_EQ(expected, context.reduce(number));
+			EXPECT_EQ(expected == 0 ? expected : modulus - expected, context.reduce(-number));
+		}
+		Big_int a = context.reduce(random_big_int(digits, gen));
+		Big_int b = context.reduce(random_big_int(digits, gen));
+		EXPECT_EQ(a * b % modulus, context.multiply(a, b));
+		EXPECT_EQ(a * a % modulus, context.square(a));
+		EXPECT_EQ(0, context.reduce(modulus * modulus - modulus));
+	}
+}
+
+TEST(BigintegerTest, add_product)
+{
+	std::mt19937 gen(29);
+	for (int i = 0; i < 40; ++i) {
+		Big_int a = random_big_int(1 + gen() % 400, gen);
+		Big_int b = random_big_int(1 + gen() % 400, gen);
+		Big_int c = i % 5 == 0 ? Big_int(0) : random_big_int(1 + gen() % 800, gen);
+		if (i % 2) {
+			a.negate();
+		}
+		if (i % 3) {
+			c.negate();
+		}
+		Big_int sum = c;
+		Big_int difference = c;
+		EXPECT_EQ(c + a * b, sum.add_product(a, b));
+		EXPECT_EQ(c - a * b, difference.sub_product(a, b));
+	}
+
+	Big_int a = 123'456'789'123;
+	Big_int expected = a + a * a;
+	EXPECT_EQ(expected, a.add_product(a, a));
+}
+
+TEST(BigintegerTest, expression_templates)
+{
+	std::mt19937 gen(31);
+	for (int i = 0; i < 20; ++i) {
+		Big_int a = random_big_int(1 + gen() % 300, gen);
+		Big_int b = -random_big_int(1 + gen() % 300, gen);
+		Big_int c = random_big_int(1 + gen() % 300, gen);
+		Big_int d = random_big_int(1 + gen() % 300, gen);
+
+		Big_int r = lazy(a) * b + lazy(c) * d;
+		EXPECT_EQ(a * b + c * d, r);
+		r = lazy(a) * b - c * lazy(d) + a - b;
+		EXPECT_EQ(a * b - c * d + a - b, r);
+		r = c - lazy(a) * lazy(b);
+		EXPECT_EQ(c - a * b, r);
+		Big_int expected = a * a + 1;
+		a = lazy(a) * a + Big_int(1); // the operands are read before the assignment
+		EXPECT_EQ(expected, a);
+	}
+
+	// One allocation for the result instead of one per operator.
+	Big_int a = random_big_int(90, gen);
+	Big_int b = random_big_int(90, gen);
+	std::size_t count = allocation_count;
+	Big_int r = lazy(a) * b + lazy(b) * a;
+	EXPECT_EQ(count + 1, allocation_count);
+	EXPECT_EQ(a * b * 2, r);
+}
+
+TEST(BigintegerTest, gcd)
+{
+	EXPECT_EQ(0, gcd(0, 0));
+	EXPECT_EQ(5, gcd(0, -5));
+	EXPECT_EQ(6, gcd(-12, 18));
+	EXPECT_EQ(1, gcd(Big_int("1000000000000000000000000000001"), Big_int("999999999999999999")));
+
+	std::mt19937 gen(19);
+	for (size_t digits : { 5, 18, 19, 40, 300, 2'000 }) {
+		Big_int common = random_big_int(1 + digits / 10, gen);
+		Big_int a = random_big_int(digits, gen);
+		Big_int b = -random_big_int(digits + gen() % 20, gen);
+		Big_int expected = a;
+		for (Big_int n = b; n; ) {
+			expected %= n;
+			expected.swap(n);
+		}
+		expected = expected < 0 ? -expected : expected;
+		EXPECT_EQ(expected, gcd(a, b));
+		EXPECT_EQ(expected * common, gcd(a * common, b * common));
+		EXPECT_EQ(a, gcd(a, a * b));
+	}
+}
+
+TEST(BigintegerTest, iroot)
+{
+	EXPECT_EQ(0, isqrt(Big_int(0)));
+	EXPECT_EQ(1, isqrt(Big_int(3)));
+	EXPECT_EQ(2, isqrt(Big_int(4)));
+	EXPECT_EQ(Big_int("1000000000000000000"), isqrt(Big_int("1" + std::string(36, '0'))));
+	EXPECT_EQ(Big_int("999999999999999999"), isqrt(Big_int("1" + std::string(36, '0')) - 1));
+	EXPECT_EQ(-3, iroot(Big_int(-27), 3));
+	EXPECT_EQ(-2, iroot(Big_int(-26), 3));
+	EXPECT_EQ(1, iroot(Big_int("123456789123456789"), 100));
+	EXPECT_THROW(isqrt(Big_int(-1)), const char*);
+	EXPECT_THROW(iroot(Big_int(-1), 4), const char*);
+	EXPECT_THROW(iroot(Big_int(5), 0), const char*);
+
+	std::mt19937 gen(53);
+	for (int i = 0; i < 60; ++i) {
+		Big_int number = random_big_int(1 + gen() % 3'000, gen);
+		unsigned long long degree = 2 + i % 7;
+		Big_int root = iroot(number, degree);
+		EXPECT_LE(pow(root, degree), number);
+		EXPECT_GT(pow(root + 1, degree), number);
+		EXPECT_EQ(root, iroot(pow(root, degree), degree));
+		EXPECT_EQ(root - 1, iroot(pow(root, degree) - 1, degree));
+	}
+}
+
+TEST(BigintegerTest, is_perfect_square)
+{
+	for (long long i = 0, root = 0; i < 10'000; ++i) {
+		if ((root + 1) * (root + 1) == i) {
+			++root;
+		}
+		EXPECT_EQ(root * root == i, is_perfect_square(Big_int(i)));
+	}
+	EXPECT_FALSE(is_perfect_square(Big_int(-4)));
+
+	std::mt19937 gen(59);
+	for (int i = 0; i < 30; ++i) {
+		Big_int root = random_big_int(1 + gen() % 1'000, gen);
+		Big_int number = square(root);
+		EXPECT_TRUE(is_perfect_square(number));
+		EXPECT_FALSE(is_perfect_square(number + 1));
+		EXPECT_FALSE(is_perfect_square(number - 1));
+		EXPECT_FALSE(is_perfect_square(number * 396 + 44));	// 11 divides it exactly once
+	}
+}
+
+TEST(BigintegerTest, shifts)
+{
+	for (long long i = -1'000; i <= 1'000; i += 7) {
+		for (unsigned shift = 0; shift < 70; ++shift) {
+			EXPECT_EQ(Big_int(i >> std::min(shift, 63u)), Big_int(i) >> shift);
+			if (shift < 50) {
+				EXPECT_EQ(Big_int(i * (1LL << shift)), Big_int(i) << shift);
+			}
+		}
+	}
+
+	std::mt19937 gen(61);
+	for (std::size_t shift : { 1, 31, 32, 93, 94, 100, 5'000, 40'000 }) {
+		Big_int number = random_big_int(3'000, gen);
+		Big_int power = pow(Big_int(2), shift);
+		EXPECT_EQ(number * power, number << shift);
+		EXPECT_EQ(number / power, number >> shift);
+		EXPECT_EQ(-number, (-number << shift) >> shift);
+		// Floor, not truncation, for negative numbers.
+		Big_int quotient = -number / power;
+		EXPECT_EQ(quotient * power == -number ? quotient : quotient - 1, -number >> shift);
+	}
+}
+
+TEST(BigintegerTest, bitwise)
+{
+	for (long long a = -40; a <= 40; ++a) {
+		for (long long b = -40; b <= 40; ++b) {
+			EXPECT_EQ(Big_int(a & b), Big_int(a) & Big_int(b));
+			EXPECT_EQ(Big_int(a | b), Big_int(a) | Big_int(b));
+			EXPECT_EQ(Big_int(a ^ b), Big_int(a) ^ Big_int(b));
+		}
+		EXPECT_EQ(Big_int(~a), ~Big_int(a));
+	}
+	EXPECT_EQ(0x0F0F'0000'FFFF'0F0FLL & -0x1234'5678'9ABC, Big_int(0x0F0F'0000'FFFF'0F0FLL) & Big_int(-0x1234'5678'9ABC));
+
+	std::mt19937 gen(67);
+	for (std::size_t digits : { 10, 300, 5'000 }) {
+		Big_int a = random_big_int(digits, gen);
+		Big_int b = -random_big_int(digits / 2 + 1, gen);
+		EXPECT_EQ(a, Big_int::from_binary(a.to_binary()));
+		EXPECT_EQ(b, Big_int::from_binary(b.to_binary(), true));
+		EXPECT_EQ(a ^ b, (a | b) - (a & b));
+		EXPECT_EQ(a + b, (a ^ b) + ((a & b) << 1));
+		EXPECT_EQ(-1, a | ~a);
+		EXPECT_EQ(0, b & ~b);
+		EXPECT_EQ(popcount(a) + popcount(~b), popcount(a ^ ~b) + 2 * popcount(a & ~b));
+	}
+	EXPECT_EQ(0, popcount(Big_int(0)));
+	EXPECT_EQ(64, popcount(pow(Big_int(2), 64) - 1));
+	EXPECT_THROW((void)popcount(Big_int(-1)), const char*);
+}
+
+TEST(BigintegerTest, factorial)
+{
+	Big_int expected = 1;
+	for (unsigned long long n = 0; n <= 3'000; ++n) {
+		if (n != 0) {
+			expected *= static_cast<long long>(n);
+		}
+		if (n <= 100 or n % 97 == 0) {
+			EXPECT_EQ(expected, factorial(n));
+		}
+	}
+	EXPECT_EQ(1, product({}));
+	EXPECT_EQ(factorial(12), product({ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 }));
+}
+
+TEST(BigintegerTest, binomial)
+{
+	std::vector<Big_int> row = { 1 };
+	for (unsigned long long n = 1; n <= 200; ++n) {
+		std::vector<Big_int> next(row.size() + 1, 1);
+		for (std::size_t k = 1; k < row.size(); ++k) {
+			next[k] = row[k - 1] + row[k];
+		}
+		row = std::move(next);
+		for (unsigned long long k = 0; k <= n; k += 1 + n / 20) {
+			EXPECT_EQ(row[k], binomial(n, k));
+		}
+	}
+	EXPECT_EQ(0, binomial(5, 6));
+	for (unsigned long long k : { 1, 64, 65, 500, 1'000 }) {
+		EXPECT_EQ(factorial(2'000) / (factorial(k) * factorial(2'000 - k)), binomial(2'000, k));
+	}
+	EXPECT_EQ(Big_int("4999999950000000"), binomial(100'000'000, 2));
+}
+
+TEST(BigintegerTest, primorial)
+{
+	const long long expected[] = { 1, 1, 2, 6, 6, 30, 30, 210, 210, 210, 210, 2'310, 2'310, 30'030 };
+	for (unsigned long long n = 0; n < std::size(expected); ++n) {
+		EXPECT_EQ(expected[n], primorial(n));
+	}
+	Big_int number = primorial(10'000);
+	for (long long p : { 2, 3, 9'973 }) {
+		EXPECT_EQ(0, number % p);
+		EXPECT_NE(0, number / p % p);
+	}
+	EXPECT_NE(0, number % 10'007);
+}
+
+TEST(BigintegerTest, xgcd)
+{
+	std::mt19937 gen(23);
+	std::vector<std::pair<Big_int, Big_int>> pairs = { { 0, 0 }, { 0, -7 }, { 12, 0 }, { -240, 46 }, { 46, -240 } };
+	for (size_t digits : { 9, 19, 100, 1'000 }) {
+		pairs.emplace_back(random_big_int(digits, gen), -random_big_int(digits + 5, gen));
+		pairs.emplace_back(random_big_int(digits, gen) * 6, random_big_int(digits, gen) * 4);
+	}
+	for (const auto& [a, b] : pairs) {
+		auto [g, x, y] = xgcd(a, b);
+		EXPECT_EQ(gcd(a, b), g);
+		EXPECT_EQ(g, a * x + b * y);
+	}
+
+	Modular_context context(1'000'000'007);
+	Big_int inverse = context.inverse(-123'456'789);
+	EXPECT_EQ(1, context.reduce(inverse * -123'456'789));
+	EXPECT_THROW(Modular_context(100).inverse(30), const char*);
+}
+
 TEST(BigintegerTest, negation_long)
 {
 	Big_int a("10000000000000000000000000000000000000000000000000000");
@@ -535,6 +1206,46 @@ TEST(BigintegerTest, string_conv)
 	EXPECT_EQ("-2147483648", lim.to_string());
 	lim--;
 	EXPECT_EQ("-2147483649", lim.to_string());
+
+	EXPECT_EQ("0", Big_int("-000").to_string());
+	EXPECT_EQ("123", Big_int("+123").to_string());
+	EXPECT_THROW(Big_int(""), const char*);
+	EXPECT_THROW(Big_int("-"), const char*);
+	EXPECT_THROW(Big_int("12a"), const char*);
+}
+
+TEST(BigintegerTest, to_chars_from_chars)
+{
+	std::mt19937 gen(7);
+	for (size_t digits : { 1, 9, 10, 18, 19, 1'000 }) {
+		Big_int a = random_big_int(digits, gen);
+		if (digits % 2 == 0) {
+			a.negate();
+		}
+		std::string buffer(a.chars_size() + 3, '#');
+		auto [end, ec] = to_chars(buffer.data(), buffer.data() + buffer.size(), a);
+		EXPECT_EQ(std::errc(), ec);
+		EXPECT_EQ(buffer.data() + a.chars_size(), end);
+		EXPECT_EQ(a.to_string(), std::string(buffer.data(), end));
+
+		Big_int b;
+		auto [ptr, parse_ec] = from_chars(buffer.data(), buffer.data() + buffer.size(), b);
+		EXPECT_EQ(std::errc(), parse_ec);
+		EXPECT_EQ(end, ptr);
+		EXPECT_EQ(a, b);
+	}
+
+	char small[3];
+	auto [end, ec] = to_chars(small, small + 3, Big_int(-123));
+	EXPECT_EQ(std::errc::value_too_large, ec);
+	EXPECT_EQ(small + 3, end);
+
+	const char text[] = "-x";
+	Big_int c = 5;
+	auto [ptr, parse_ec] = from_chars(text, text + 2, c);
+	EXPECT_EQ(std::errc::invalid_argument, parse_ec);
+	EXPECT_EQ(text, ptr);
+	EXPECT_EQ(5, c);
 }
 
 template <typename T>
@@ -546,6 +1257,110 @@ void test_converting_ctor(T value)
 	EXPECT_EQ(to_string(value), bi.to_string());
 }
 
+TEST(BigintegerTest, serialization)
+{
+	std::mt19937 gen(71);
+	std::vector<Big_int> numbers = { 0, 1, -1, 127, 128, -999'999'999, Big_int("999999999999999999"),
+		Big_int("-1000000000000000000") };
+	for (std::size_t digits : { 20, 100, 10'000 }) {
+		numbers.push_back(random_big_int(digits, gen));
+		numbers.push_back(-random_big_int(digits, gen));
+	}
+	std::vector<std::byte> buffer;
+	std::stringstream stream;
+	for (const auto& number : numbers) {
+		std::size_t size = buffer.size();
+		serialize(number, buffer);
+		EXPECT_EQ(serialized_size(number), buffer.size() - size);
+		serialize(number, stream);
+	}
+	EXPECT_EQ(2, serialized_size(Big_int(127)));
+	EXPECT_EQ(3, serialized_size(Big_int(128)));
+	EXPECT_EQ(1 + 1 + 4 * 3, serialized_size(Big_int("-1000000000000000000")));
+
+	std::span<const std::byte> in(buffer);
+	Big_int value = 5;
+	for (const auto& number : numbers) {
+		in = in.subspan(deserialize(in, value));
+		EXPECT_EQ(number, value);
+		deserialize(stream, value);
+		EXPECT_EQ(number, value);
+	}
+	EXPECT_TRUE(in.empty());
+	EXPECT_THROW(deserialize(stream, value), const char*);
+
+	std::vector<std::byte> encoded;
+	serialize(numbers.back(), encoded);
+	EXPECT_THROW(deserialize(std::span<const std::byte>(encoded).first(encoded.size() - 1), value), const char*);
+	EXPECT_THROW(serialize(numbers.back(), std::span<std::byte>(encoded).first(encoded.size() - 1)), const char*);
+	encoded[0] ^= std::byte(1 << 2);	// version
+	EXPECT_THROW(deserialize(encoded, value), const char*);
+	encoded[0] ^= std::byte(1 << 2);
+	encoded.back() = std::byte(0xFF);	// leading limb out of range
+	EXPECT_THROW(deserialize(encoded, value), const char*);
+	EXPECT_THROW(deserialize(std::vector<std::byte>{ std::byte(SERIALIZATION_VERSION << 2 | 3), std::byte(0) }, value), const char*);
+
+	// Padded varints: 5 as { 0x85, 0x00 } and the limb count 3 as { 0x83, 0x00 }.
+	const std::byte compact = std::byte(SERIALIZATION_VERSION << 2 | 1);
+	const std::byte full = std::byte(SERIALIZATION_VERSION << 2);
+	EXPECT_EQ(deserialize(std::vector<std::byte>{ compact, std::byte(0x05) }, value), 2);
+	EXPECT_EQ(value, 5);
+	EXPECT_THROW(deserialize(std::vector<std::byte>{ compact, std::byte(0x85), std::byte(0) }, value), const char*);
+	std::vector<std::byte> limbs = { full, std::byte(0x03) };
+	for (int limb : { 1, 0, 1 }) {
+		limbs.insert(limbs.end(), { std::byte(limb), std::byte(0), std::byte(0), std::byte(0) });
+	}
+	EXPECT_EQ(deserialize(limbs, value), limbs.size());
+	EXPECT_EQ(value, "1000000000000000001"_bi);
+	limbs.insert(limbs.begin() + 2, std::byte(0));
+	limbs[1] = std::byte(0x83);
+	EXPECT_THROW(deserialize(limbs, value), const char*);
+	std::stringstream padded_stream;
+	padded_stream.write(reinterpret_cast<const char*>(limbs.data()), static_cast<std::streamsize>(limbs.size()));
+	EXPECT_THROW(deserialize(padded_stream, value), const char*);
+
+	Rational ratio(Big_int("-123456789012345678901234567890"), Big_int(7));
+	Rational ratio_value;
+	std::vector<std::byte> ratio_buffer;
+	serialize(ratio, ratio_buffer);
+	EXPECT_EQ(serialized_size(ratio), deserialize(ratio_buffer, ratio_value));
+	EXPECT_EQ(ratio, ratio_value);
+	serialize(Big_int(1), ratio_buffer);
+	serialize(Big_int(-2), ratio_buffer);
+	EXPECT_THROW(deserialize(std::span<const std::byte>(ratio_buffer).subspan(serialized_size(ratio)), ratio_value), const char*);
+}
+
+TEST(BigintegerTest, mapped_big_int_array)
+{
+	std::mt19937 gen(73);
+	std::vector<Big_int> numbers;
+	for (int i = 0; i < 200; ++i) {
+		numbers.push_back(i % 2 ? random_big_int(1 + gen() % 500, gen) : -Big_int(i));
+	}
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "big_int_mapped_array_test.bin";
+	{
+		std::ofstream file(path, std::ios::binary);
+		for (const auto& number : numbers) {
+			serialize(number, file);
+		}
+	}
+	{
+		Mapped_big_int_array array(path.string());
+		ASSERT_EQ(numbers.size(), array.size());
+		for (std::size_t i = 0; i < numbers.size(); ++i) {
+			EXPECT_EQ(numbers[i], array[i]);
+		}
+		EXPECT_THROW((void)array[numbers.size()], const char*);
+	}
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::app);
+		file.put(static_cast<char>(SERIALIZATION_VERSION << 2));
+	}
+	EXPECT_THROW(Mapped_big_int_array(path.string()), const char*);
+	std::filesystem::remove(path);
+	EXPECT_THROW(Mapped_big_int_array(path.string()), const char*);
+}
+
 TEST(BigintegerTest, converting_ctor)
 {
 	using std::numeric_limits;
@@ -616,6 +1431,105 @@ TEST(BigintegerTest, literals)
 	EXPECT_TRUE("-2147483647"_bi + 2147483647_bi == 0);
 }
 
+TEST(BigintegerTest, literals_beyond_word)
+{
+	EXPECT_EQ(123456789012345678901234567890_bi, Big_int("123456789012345678901234567890"));
+	EXPECT_EQ(18446744073709551616_bi, pow(Big_int(2), 64));
+	EXPECT_EQ(1'000'000'000'000_bi, 1000000000000_bi);
+	EXPECT_EQ(0xFFFF'FFFF'FFFF'FFFF'FFFF_bi, pow(Big_int(2), 80) - 1);
+	EXPECT_EQ(0x1234abcdEF_bi, 0x1234abcdEFLL);
+	EXPECT_EQ(0b1011_bi, 11);
+	EXPECT_EQ(0777_bi, 511);
+	EXPECT_EQ(0_bi, 0);
+}
+
+namespace
+{
+using Constant = Big_int_constant<8>;
+
+/// Factorials up to 40!, computed by the compiler.
+constexpr std::array<Constant, 41> factorials = [] {
+	std::array<Constant, 41> ret{};
+	ret[0] = 1;
+	for (int i = 1; i < 41; ++i) {
+		ret[i] = ret[i - 1] * i;
+	}
+	return ret;
+}();
+
+static_assert(factorials[20] == Constant(2432902008176640000LL));
+static_assert(factorials[40] == Constant("815915283247897734345611269596115894272000000000"));
+static_assert(factorials[40] - factorials[40] == 0);
+static_assert(-factorials[30] < factorials[3] and factorials[3] < factorials[4]);
+static_assert(Constant("-999999999999999999") + 1 == Constant(-999999999999999998LL));
+static_assert(Constant(-5) * Constant(7) == -35 and Constant(-5) * Constant(-7) == 35);
+static_assert(Constant(std::numeric_limits<long long>::min()) - 1 == Constant("-9223372036854775809"));
+static_assert(parse_integer_literal<8>("0x1'0000'0000") == Constant(4294967296LL));
+}
+
+TEST(BigintegerTest, hash)
+{
+	std::mt19937 gen(24);
+	std::hash<Big_int> hasher;
+	EXPECT_EQ(hasher(0), hasher(-Big_int(0)));
+	EXPECT_EQ(hasher("-0"_bi), hasher(Big_int(5) - 5));
+	EXPECT_NE(hasher(1), hasher(-1));
+	EXPECT_NE(hasher(0), hasher(pow(Big_int(10), 36)));
+	EXPECT_NE(hasher(1), hasher(pow(Big_int(10), 36)));
+
+	std::unordered_set<std::size_t> hashes;
+	std::unordered_set<Big_int> numbers;
+	for (int i = 0; i < 2'000; ++i) {
+		Big_int a = i < 1'000 ? Big_int(i - 500) : random_big_int(1 + gen() % 80, gen);
+		numbers.insert(a);
+		hashes.insert(hasher(a));
+		EXPECT_EQ(hasher(a), hasher(Big_int(a.to_string())));
+		EXPECT_EQ(hasher(a), hasher(a * 7 / 7));
+		EXPECT_TRUE(numbers.contains(a));
+	}
+	EXPECT_EQ(hashes.size(), numbers.size());
+
+	std::unordered_map<Big_int, int> counts;
+	for (int i = 0; i < 100; ++i) {
+		++counts[pow(Big_int(3), i % 10 + 20)];
+	}
+	EXPECT_EQ(counts.size(), 10);
+	EXPECT_EQ(counts[pow(Big_int(3), 25)], 10);
+}
+
+TEST(BigintegerTest, constant)
+{
+	std::mt19937 gen(23);
+	for (int i = 0; i < 200; ++i) {
+		Big_int a = random_big_int(1 + gen() % 35, gen);
+		Big_int b = random_big_int(1 + gen() % 35, gen);
+		if (gen() % 2) {
+			a.negate();
+		}
+		Constant ca(a.to_string());
+		Constant cb(b.to_string());
+		EXPECT_EQ(Big_int(ca + cb), a + b);
+		EXPECT_EQ(Big_int(ca - cb), a - b);
+		EXPECT_EQ(Big_int(ca * cb), a * b);
+		EXPECT_EQ(ca < cb, a < b);
+		EXPECT_EQ(ca == cb, a == b);
+	}
+
+	Big_int factorial = 1;
+	for (int i = 0; i < 41; ++i) {
+		EXPECT_EQ(Big_int(factorials[i]), factorial);
+		factorial *= i + 1;
+	}
+	EXPECT_EQ(Big_int(Constant("-0")), 0);
+	EXPECT_FALSE(Big_int(Constant("-0")) < 0);
+
+	EXPECT_THROW(Constant("12a"), const char*);
+	EXPECT_THROW(Constant(""), const char*);
+	EXPECT_THROW(Big_int_constant<2>("1000000000000000000"), const char*);
+	EXPECT_THROW(Big_int_constant<2>(999'999'999'999'999'999LL) + 1, const char*);
+	EXPECT_THROW(Big_int_constant<2>(1'000'000'000) * 1'000'000'000, const char*);
+}
+
 TEST(BigintegerTest, static_cast_int)
 {
 	Big_int a = std::numeric_limits<int>::min();
@@ -910,6 +1824,83 @@ TEST(RationalTest, as_decimal)
 	EXPECT_EQ("0.99", Rational(-99, -100).as_decimal(2));
 }
 
+TEST(RationalTest, hash)
+{
+	std::hash<Rational> hasher;
+	EXPECT_EQ(hasher(Rational(2, 4)), hasher(Rational(1, 2)));
+	EXPECT_EQ(hasher(Rational(1, -3)), hasher(Rational(-1, 3)));
+	EXPECT_EQ(hasher(Rational(0, 5)), hasher(Rational()));
+	EXPECT_NE(hasher(Rational(1, 2)), hasher(Rational(2, 1)));
+	EXPECT_NE(hasher(Rational(1, 2)), hasher(Rational(-1, 2)));
+
+	std::unordered_map<Rational, int> values;
+	for (int numerator = -20; numerator <= 20; ++numerator) {
+		for (int denominator = 1; denominator <= 20; ++denominator) {
+			values[Rational(numerator, denominator)] = numerator * denominator;
+		}
+	}
+	// Distinct fractions in lowest terms with |numerator| and denominator up to 20.
+	std::size_t count = 1;
+	for (int numerator = 1; numerator <= 20; ++numerator) {
+		for (int denominator = 1; denominator <= 20; ++denominator) {
+			count += std::gcd(numerator, denominator) == 1 ? 2 : 0;
+		}
+	}
+	EXPECT_EQ(values.size(), count);
+	EXPECT_TRUE(values.contains(Rational(3, 6)));
+	EXPECT_FALSE(values.contains(Rational(1, 21)));
+}
+
+TEST(RationalTest, accumulator)
+{
+	Rational harmonic;
+	Rational_accumulator lazy_harmonic;
+	for (int k = 1; k <= 300; ++k) {
+		harmonic += Rational(1, k);
+		lazy_harmonic += Rational(1, k);
+	}
+	EXPECT_EQ(lazy_harmonic.value(), harmonic);
+	EXPECT_EQ(lazy_harmonic.to_string(), harmonic.to_string());
+	EXPECT_TRUE(lazy_harmonic == harmonic);
+	EXPECT_TRUE(lazy_harmonic > Rational(6));
+	EXPECT_TRUE(lazy_harmonic < Rational(7));
+
+	std::size_t threshold = Rational_accumulator::reduce_threshold;
+	std::mt19937 gen(25);
+	for (std::size_t reduce_threshold : { std::size_t(0), std::size_t(20), std::size_t(100'000) }) {
+		Rational_accumulator::reduce_threshold = reduce_threshold;
+		Rational eager(3, 7);
+		Rational_accumulator lazy(eager);
+		for (int i = 0; i < 200; ++i) {
+			Rational rhs(static_cast<int>(gen() % 2'001) - 1'000, static_cast<int>(gen() % 1'000) + 1);
+			switch (i % 6) {
+			case 0: case 1: eager += rhs; lazy += rhs; break;
+			case 2: case 3: eager -= rhs; lazy -= rhs; break;
+			case 4: eager *= rhs; lazy *= rhs; break;
+			default:
+				if (rhs != 0) {
+					eager /= rhs;
+					lazy /= rhs;
+				}
+			}
+			ASSERT_TRUE(lazy == eager);
+			ASSERT_EQ(lazy <=> Rational_accumulator(eager + Rational(1, 1'000'000)), std::strong_ordering::less);
+		}
+		EXPECT_EQ(lazy.value(), eager);
+		lazy.reduce();
+		EXPECT_EQ(lazy.value(), eager);
+	}
+	Rational_accumulator::reduce_threshold = threshold;
+
+	Rational_accumulator lazy(Rational(1, 2));
+	lazy /= Rational(-1, 3);
+	EXPECT_EQ(lazy.value(), Rational(-3, 2));
+	lazy -= Rational(-3, 2);
+	EXPECT_EQ(lazy.value(), Rational());
+	EXPECT_EQ(lazy.to_string(), "0");
+	EXPECT_THROW(lazy /= Rational(), const char*);
+}
+
 TEST(RationalTest, static_cast_double)
 {
 	EXPECT_EQ(std::to_string(1.0 / 3), std::to_string(static_cast<double>(Rational(1, 3))));
@@ -961,8 +1952,291 @@ TEST(RationalTest, static_cast_double)
 	EXPECT_EQ(std::to_string(-731946285.0 / -28731946), std::to_string(static_cast<double>(Rational(-731946285, -28731946))));
 }
 
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//class Big_uint
+
+template <typename T>
+class BiguintTest : public ::testing::Test {};
+
+using Limb_types = ::testing::Types<Basic_big_uint<std::uint32_t>, Big_uint>;
+TYPED_TEST_SUITE(BiguintTest, Limb_types);
+
+TYPED_TEST(BiguintTest, string_conv)
+{
+	std::mt19937 gen(5);
+	std::vector<std::string> values = { "0", "1", "4294967295", "4294967296", "18446744073709551616", "1000000000000000000000" };
+	for (size_t digits : { 100, 1'000, 10'000 }) {
+		values.push_back(random_big_int(digits, gen).to_string());
+		values.push_back("1" + std::string(digits, '0'));
+	}
+	for (const auto& str : values) {
+		EXPECT_EQ(str, TypeParam(str).to_string());
+	}
+	EXPECT_EQ("123", TypeParam("+000123").to_string());
+	EXPECT_THROW(TypeParam(std::string("")), const char*);
+	EXPECT_THROW(TypeParam(std::string("+")), const char*);
+	EXPECT_THROW(TypeParam(std::string("-5")), const char*);
+	EXPECT_THROW(TypeParam(std::string("12x4")), const char*);
+	EXPECT_THROW(TypeParam(std::string("+-1")), const char*);
+}
+
+TYPED_TEST(BiguintTest, arithmetic_matches_big_int)
+{
+	std::mt19937 gen(6);
+	std::uniform_int_distribution<size_t> digits_dist(1, 2'000);
+	for (size_t i = 0; i < 200; ++i) {
+		std::string lhs = random_big_int(digits_dist(gen), gen).to_string();
+		std::string rhs = random_big_int(digits_dist(gen), gen).to_string();
+		TypeParam a(lhs);
+		TypeParam b(rhs);
+		Big_int x(lhs);
+		Big_int y(rhs);
+
+		EXPECT_EQ((x + y).to_string(), (a + b).to_string());
+		EXPECT_EQ((x * y).to_string(), (a * b).to_string());
+		EXPECT_EQ((x / y).to_string(), (a / b).to_string());
+		EXPECT_EQ((x % y).to_string(), (a % b).to_string());
+		if (a >= b) {
+			EXPECT_EQ((x - y).to_string(), (a - b).to_string());
+		}
+		else {
+			EXPECT_THROW(a - b, const char*);
+		}
+	}
+}
+
+TYPED_TEST(BiguintTest, shifts)
+{
+	TypeParam one(1);
+	EXPECT_EQ("340282366920938463463374607431768211456", (one << 128).to_string());
+	EXPECT_EQ(129, (one << 128).bit_length());
+	EXPECT_EQ(one, (one << 1'000) >> 1'000);
+	EXPECT_EQ(TypeParam(0), (one << 100) >> 101);
+	EXPECT_EQ(TypeParam(3), TypeParam("13835058055282163712") >> 62);
+}
+
+TYPED_TEST(BiguintTest, bitwise)
+{
+	TypeParam a("340282366920938463463374607431768211455");	// 2^128 - 1
+	TypeParam b(0xF0F0'F0F0'F0F0'F0F0ULL);
+	EXPECT_EQ(b, a & b);
+	EXPECT_EQ(a, a | b);
+	EXPECT_EQ(a - b, a ^ b);
+	EXPECT_EQ(TypeParam(0), b ^ b);
+	EXPECT_EQ(128, a.popcount());
+	EXPECT_EQ(32, b.popcount());
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//class Fixed_int
+
+using Fixed_int_256 = Fixed_int<256>;
+
+static_assert(Fixed_int_256(-7) / Fixed_int_256(2) == Fixed_int_256(-3));
+static_assert(Fixed_int_256(-7) % Fixed_int_256(2) == Fixed_int_256(-1));
+static_assert(-Fixed_int_256::max() < Fixed_int_256(0));
+
+TEST(FixedIntTest, arithmetic_matches_big_int)
+{
+	std::mt19937 gen(79);
+	const Big_int limit = pow(Big_int(2), 256);
+	auto fits = [&](const Big_int& number) {
+		return (number < 0 ? -number : number) < limit;
+	};
+	for (int i = 0; i < 2'000; ++i) {
+		Big_int a = random_big_int(1 + gen() % 77, gen);
+		Big_int b = random_big_int(1 + gen() % 77, gen);
+		if (gen() % 2) {
+			a.negate();
+		}
+		if (gen() % 2) {
+			b.negate();
+		}
+		Fixed_int_256 x(a);
+		Fixed_int_256 y(b);
+		EXPECT_EQ(a, x.to_big_int());
+		EXPECT_EQ(a.to_string(), x.to_string());
+		EXPECT_EQ(a < b, x < y);
+
+		Fixed_int_256 result = x;
+		EXPECT_EQ(fits(a + b), result.try_add(y));
+		EXPECT_EQ(fits(a + b) ? a + b : a, result.to_big_int());
+		result = x;
+		EXPECT_EQ(fits(a - b), result.try_subtract(y));
+		EXPECT_EQ(fits(a - b) ? a - b : a, result.to_big_int());
+		result = x;
+		EXPECT_EQ(fits(a * b), result.try_multiply(y));
+		EXPECT_EQ(fits(a * b) ? a * b : a, result.to_big_int());
+		EXPECT_EQ(a / b, (x / y).to_big_int());
+		EXPECT_EQ(a % b, (x % y).to_big_int());
+	}
+}
+
+TEST(FixedIntTest, overflow)
+{
+	Fixed_int_256 max = Fixed_int_256::max();
+	EXPECT_EQ(pow(Big_int(2), 256) - 1, max.to_big_int());
+	EXPECT_THROW(max + 1, const char*);
+	EXPECT_THROW(-max - 1, const char*);
+	EXPECT_THROW(max * 2, const char*);
+	EXPECT_THROW(Fixed_int_256(pow(Big_int(2), 256)), const char*);
+	EXPECT_THROW(max / 0, const char*);
+	EXPECT_EQ(0, max - max);
+	EXPECT_EQ(1, max / max);
+
+	// Promotion to Big_int on overflow.
+	Fixed_int_256 product = Fixed_int_256(pow(Big_int(10), 70));
+	Big_int promoted;
+	if (!product.try_multiply(product)) {
+		promoted = product.to_big_int() * product.to_big_int();
+	}
+	EXPECT_EQ(pow(Big_int(10), 140), promoted);
+	EXPECT_EQ(Rational(1, 3), Rational(Fixed_int_256(10).to_big_int(), Fixed_int_256(30).to_big_int()));
+}
+
+TEST(FixedIntTest, matrix)
+{
+	std::vector<std::vector<int>> a = { { 1, -2, 3 }, { 4, 5, -6 }, { -7, 8, 9 } };
+	std::vector<std::vector<int>> b = { { 9, 8, 7 }, { -6, 5, 4 }, { 3, -2, 1 } };
+	auto fixed = Mtx::Square_matrix<3, Fixed_int_256>(a) * Mtx::Square_matrix<3, Fixed_int_256>(b);
+	auto big = Mtx::Square_matrix<3, Big_int>(a) * Mtx::Square_matrix<3, Big_int>(b);
+	fixed *= 1'000;
+	big *= 1'000;
+	for (std::size_t i = 0; i < 3; ++i) {
+		for (std::size_t j = 0; j < 3; ++j) {
+			EXPECT_EQ(big[i][j], fixed[i][j].to_big_int());
+		}
+	}
+	EXPECT_EQ(big.trace(), fixed.trace().to_big_int());
+}
+
+// class Limb_vector
+
+TEST(BigintegerTest, simd_levels)
+{
+	// Long runs of 999999999 and 0 make the carries and borrows ripple across blocks.
+	std::mt19937 gen(41);
+	auto operand = [&gen](size_t size) {
+		std::string str;
+		while (str.size() < size) {
+			switch (gen() % 3) {
+			case 0: str += std::string(1 + gen() % 40, '9'); break;
+			case 1: str += std::string(1 + gen() % 40, '0'); break;
+			default: str += random_big_int(1 + gen() % 40, gen).to_string();
+			}
+		}
+		str.front() = '9';
+		return Big_int(str.substr(0, size));
+	};
+
+	const Simd_level simd_level = Big_int::simd_level;
+	for (int i = 0; i < 100; ++i) {
+		Big_int a = operand(1 + gen() % 600);
+		Big_int b = i % 4 == 0 ? a - Big_int(1 + gen() % 3) : operand(1 + gen() % 600);
+		if (i % 3 == 0) {
+			b.negate();
+		}
+		Big_int::simd_level = Simd_level::scalar;
+		Big_int sum = a + b;
+		Big_int difference = a - b;
+		bool is_less = a < b;
+		for (int level = 1; level <= static_cast<int>(supported_simd_level()); ++level) {
+			Big_int::simd_level = static_cast<Simd_level>(level);
+			EXPECT_EQ(sum.to_string(), (a + b).to_string());
+			EXPECT_EQ(difference.to_string(), (a - b).to_string());
+			EXPECT_EQ(is_less, a < b);
+			EXPECT_EQ(a, a - b + b);
+		}
+	}
+	Big_int::simd_level = simd_level;
+}
+
+TEST(LimbVectorTest, spill_to_heap)
+{
+	Limb_vector<unsigned int, 4> vec(3, 7);
+	EXPECT_TRUE(vec.is_inline());
+	vec.push_back(8);
+	EXPECT_TRUE(vec.is_inline());
+	vec.push_back(9);
+	EXPECT_FALSE(vec.is_inline());
+	EXPECT_EQ((Limb_vector<unsigned int, 4>{ 7, 7, 7, 8, 9 }), vec);
+
+	vec.insert(vec.begin(), 2, 0);
+	EXPECT_EQ((Limb_vector<unsigned int, 4>{ 0, 0, 7, 7, 7, 8, 9 }), vec);
+	vec.erase(vec.begin(), vec.begin() + 3);
+	EXPECT_EQ((Limb_vector<unsigned int, 4>{ 7, 7, 8, 9 }), vec);
+
+	Limb_vector<unsigned int, 4> moved(std::move(vec));
+	EXPECT_TRUE(vec.empty());
+	EXPECT_TRUE(vec.is_inline());
+	EXPECT_EQ(4u, moved.size());
+	moved.resize(2);
+	Limb_vector<unsigned int, 4> copy(moved);
+	EXPECT_TRUE(copy.is_inline());
+	EXPECT_EQ((Limb_vector<unsigned int, 4>{ 7, 7 }), copy);
+}
+
+TEST(LimbVectorTest, small_arithmetic_does_not_allocate)
+{
+	Big_int a = 123'456'789'012'345'678;
+	Big_int b = -987'654'321;
+	Big_int c = 0;
+
+	std::size_t count = allocation_count;
+	c = a + b;
+	EXPECT_EQ(count, allocation_count);
+	c = a - b;
+	EXPECT_EQ(count, allocation_count);
+	c = a * b;
+	EXPECT_EQ(count, allocation_count);
+	c = a / b;
+	EXPECT_EQ(count, allocation_count);
+	c = a % b;
+	EXPECT_EQ(count, allocation_count);
+	c += a;
+	c *= b;
+	Big_int d = c;
+	d = -d;
+	++d;
+	EXPECT_EQ(count, allocation_count);
+	EXPECT_EQ("120427290001335989122404934089165120", (a * b * b - a).to_string());
+
+	Big_int large("1" + std::string(100, '0'));
+	count = allocation_count;
+	Big_int e = large;
+	EXPECT_EQ(count + 1, allocation_count);
+	EXPECT_EQ(large, e);
+}
+
 int main(int argc, char* argv[])
 {
 	::testing::InitGoogleTest(&argc, argv);
 	return RUN_ALL_TESTS();
 }
+
+TEST(LimbVectorTest, scoped_arena)
+{
+	std::mt19937 gen(47);
+	Big_int a = random_big_int(200, gen);
+	Big_int b = random_big_int(200, gen);
+	Big_int expected = a * b * 3 + a;
+
+	Big_int outer = 1;
+	std::size_t count = allocation_count;
+	{
+		Scoped_limb_arena arena;
+		Big_int inner = a * b;
+		for (int i = 0; i < 100; ++i) {
+			inner = a * b + inner - a * b;
+		}
+		outer = inner * 3 + a;	// outer keeps its own storage
+		Rational r(a, b);
+		r += Rational(b, a);
+		EXPECT_EQ(r, Rational(a * a + b * b, a * b));
+	}
+	// Only the chunks of the arena, instead of several allocations per iteration.
+	EXPECT_GT(count + 10, allocation_count);
+
+	EXPECT_EQ(expected, outer);
+	EXPECT_EQ(nullptr, current_limb_resource());
+}